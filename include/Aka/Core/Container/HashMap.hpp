@@ -1,30 +1,481 @@
 #pragma once
 
 #include <set>
-#include <unordered_set>
 #include <map>
-#include <unordered_map>
+#include <memory>
+#include <utility>
+#include <functional>
 
+#include <Aka/Core/Config.h>
+#include <Aka/Memory/Memory.h>
 #include <Aka/Core/Container/StlAllocator.hpp>
 
 namespace aka {
 
 
-template <typename K, typename T, typename Comp = ::std::less<K>> 
+template <typename K, typename T, typename Comp = ::std::less<K>>
 using TreeMap = ::std::map<K, T, Comp, AkaStlAllocator<::std::pair<const K, T>, AllocatorMemoryType::Map, AllocatorCategory::Global>>;
 
-template <typename K, typename T, typename Hasher = ::std::hash<K>, typename Equal = ::std::equal_to<K>>
-using HashMap = ::std::unordered_map<K, T, Hasher, Equal, AkaStlAllocator<::std::pair<const K, T>, AllocatorMemoryType::Map, AllocatorCategory::Global>>;
+template <typename Type, typename Comp = ::std::less<Type>>
+using TreeSet = std::set<Type, Comp, AkaStlAllocator<Type, AllocatorMemoryType::Set, AllocatorCategory::Global>>;
 
+// Open addressing hash table using robin hood probing, base of HashMap & HashSet.
+// Values are stored densely in insertion order & buckets only store an index to them, so iteration is contiguous.
+// Erase move the last value in the hole & shift following buckets backward, so there is no tombstone.
+// Inserting or erasing invalidates iterators & references to values.
+template <typename Key, typename Value, typename KeyOf, typename Hasher, typename Equal, AllocatorMemoryType MemoryType, AllocatorCategory Category>
+class HashTable
+{
+public:
+	using key_type = Key;
+	using value_type = Value;
+	using size_type = size_t;
+	using iterator = Value*;
+	using const_iterator = const Value*;
+public:
+	HashTable();
+	HashTable(const HashTable& table);
+	HashTable(HashTable&& table);
+	HashTable& operator=(const HashTable& table);
+	HashTable& operator=(HashTable&& table);
+	~HashTable();
 
-//template <typename Key, typename Type>
-//using LinkedHashMap = std::map<Key, Type>;
+	iterator begin() { return m_values; }
+	iterator end() { return m_values + m_size; }
+	const_iterator begin() const { return m_values; }
+	const_iterator end() const { return m_values + m_size; }
 
+	// Get the number of values
+	size_t size() const { return m_size; }
+	// Check if table is empty
+	bool empty() const { return m_size == 0; }
+	// Remove all values, keeping memory
+	void clear();
+	// Allocate memory for count values
+	void reserve(size_t count);
 
-template <typename Type, typename Hasher = ::std::hash<Type>, typename Equal = ::std::equal_to<Type>>
-using HashSet = std::unordered_set<Type, Hasher, Equal, AkaStlAllocator<Type, AllocatorMemoryType::Set, AllocatorCategory::Global>>;
+	// Find the value of key, end if missing
+	iterator find(const Key& key);
+	// Find the value of key, end if missing
+	const_iterator find(const Key& key) const;
+	// Get number of values with key
+	size_t count(const Key& key) const { return contains(key) ? 1 : 0; }
+	// Check if key is in table
+	bool contains(const Key& key) const { return findBucket(key) != invalidIndex; }
 
-template <typename Type, typename Comp = ::std::less<Type>>
-using TreeSet = std::set<Type, Comp, AkaStlAllocator<Type, AllocatorMemoryType::Set, AllocatorCategory::Global>>;
+	// Insert a value if its key is missing. Return the value with this key & whether it was inserted.
+	std::pair<iterator, bool> insert(const Value& value);
+	// Insert a value if its key is missing. Return the value with this key & whether it was inserted.
+	std::pair<iterator, bool> insert(Value&& value);
+	// Construct & insert a value if its key is missing.
+	template <typename... Args> std::pair<iterator, bool> emplace(Args&&... args);
+
+	// Erase the value of key. Return the number of erased values.
+	size_t erase(const Key& key);
+	// Erase the value at iterator. Return the iterator to the next value, which is at the same position.
+	iterator erase(const_iterator it);
+protected:
+	// Insert a value constructed from args if key is missing.
+	template <typename K, typename... Args> std::pair<iterator, bool> emplaceKey(const K& key, Args&&... args);
+private:
+	struct Bucket
+	{
+		uint32_t distAndFingerprint; // Distance from ideal bucket in high bits, hash fingerprint in low bits. Zero if empty.
+		uint32_t valueIndex; // Index of the value in dense array
+	};
+	static constexpr size_t invalidIndex = ~size_t(0);
+	static constexpr uint32_t distIncrement = 1U << 8;
+	static constexpr uint32_t fingerprintMask = distIncrement - 1;
+	static constexpr size_t minBucketCount = 8;
+
+	// Maximum number of values for a bucket count, for a max load factor of 80%
+	static size_t getMaxSize(size_t bucketCount) { return bucketCount * 4 / 5; }
+	// Mix bits of the hash as std::hash is identity for integers & pointers.
+	static uint64_t mix(uint64_t hash);
+	size_t nextBucket(size_t index) const { return (index + 1) & (m_bucketCount - 1); }
+	// Get the bucket index of key, invalidIndex if missing
+	size_t findBucket(const Key& key) const;
+	// Insert the bucket of a value, shifting richer buckets.
+	void placeBucket(uint32_t valueIndex);
+	// Erase the bucket at index & its value
+	void eraseAt(size_t bucketIndex);
+	// Reallocate buckets & values for a bucket count
+	void reallocate(size_t bucketCount);
+	// Release all memory
+	void release();
+	Allocator& getAllocator() const { return mem::getAllocator(MemoryType, Category); }
+private:
+	Value* m_values; // Dense values, with capacity of getMaxSize(m_bucketCount)
+	Bucket* m_buckets;
+	size_t m_size;
+	size_t m_bucketCount;
+	uint32_t m_shift; // Shift to get bucket index from hash
+	Hasher m_hasher;
+	Equal m_equal;
+};
+
+template <typename K, typename T>
+struct HashMapKeyOf
+{
+	static const K& get(const std::pair<const K, T>& value) { return value.first; }
+};
+
+template <typename K>
+struct HashSetKeyOf
+{
+	static const K& get(const K& value) { return value; }
+};
+
+// Flat hash map, see HashTable. Keys are const so that they cannot be changed through iterators.
+template <typename K, typename T, typename Hasher = ::std::hash<K>, typename Equal = ::std::equal_to<K>, AllocatorCategory Category = AllocatorCategory::Global>
+class HashMap final : public HashTable<K, std::pair<const K, T>, HashMapKeyOf<K, T>, Hasher, Equal, AllocatorMemoryType::Map, Category>
+{
+	using Base = HashTable<K, std::pair<const K, T>, HashMapKeyOf<K, T>, Hasher, Equal, AllocatorMemoryType::Map, Category>;
+public:
+	using mapped_type = T;
+	using iterator = typename Base::iterator;
+	using const_iterator = typename Base::const_iterator;
+	using Base::insert;
+
+	// Get the value of key, inserting a default one if missing.
+	T& operator[](const K& key) { return this->emplaceKey(key, std::piecewise_construct, std::forward_as_tuple(key), std::forward_as_tuple()).first->second; }
+	// Get the value of key, inserting a default one if missing.
+	T& operator[](K&& key) { return this->emplaceKey(key, std::piecewise_construct, std::forward_as_tuple(std::move(key)), std::forward_as_tuple()).first->second; }
+	// Get the value of key, which must exist.
+	T& at(const K& key);
+	// Get the value of key, which must exist.
+	const T& at(const K& key) const;
+	// Construct the value of key from args if key is missing.
+	template <typename... Args> std::pair<iterator, bool> try_emplace(const K& key, Args&&... args);
+};
+
+// Flat hash set, see HashTable.
+template <typename Type, typename Hasher = ::std::hash<Type>, typename Equal = ::std::equal_to<Type>, AllocatorCategory Category = AllocatorCategory::Global>
+class HashSet final : public HashTable<Type, Type, HashSetKeyOf<Type>, Hasher, Equal, AllocatorMemoryType::Set, Category>
+{
+	using Base = HashTable<Type, Type, HashSetKeyOf<Type>, Hasher, Equal, AllocatorMemoryType::Set, Category>;
+public:
+	// Values of a set cannot be modified as they are keys.
+	using iterator = typename Base::const_iterator;
+	using const_iterator = typename Base::const_iterator;
+
+	const_iterator begin() const { return Base::begin(); }
+	const_iterator end() const { return Base::end(); }
+	const_iterator find(const Type& key) const { return Base::find(key); }
+	std::pair<const_iterator, bool> insert(const Type& value) { return Base::insert(value); }
+	std::pair<const_iterator, bool> insert(Type&& value) { return Base::insert(std::move(value)); }
+	template <typename... Args> std::pair<const_iterator, bool> emplace(Args&&... args) { return Base::emplace(std::forward<Args>(args)...); }
+};
+
+template <typename Key, typename Value, typename KeyOf, typename Hasher, typename Equal, AllocatorMemoryType MemoryType, AllocatorCategory Category>
+inline HashTable<Key, Value, KeyOf, Hasher, Equal, MemoryType, Category>::HashTable() :
+	m_values(nullptr),
+	m_buckets(nullptr),
+	m_size(0),
+	m_bucketCount(0),
+	m_shift(64),
+	m_hasher(),
+	m_equal()
+{
+}
+
+template <typename Key, typename Value, typename KeyOf, typename Hasher, typename Equal, AllocatorMemoryType MemoryType, AllocatorCategory Category>
+inline HashTable<Key, Value, KeyOf, Hasher, Equal, MemoryType, Category>::HashTable(const HashTable& table) :
+	HashTable()
+{
+	*this = table;
+}
+
+template <typename Key, typename Value, typename KeyOf, typename Hasher, typename Equal, AllocatorMemoryType MemoryType, AllocatorCategory Category>
+inline HashTable<Key, Value, KeyOf, Hasher, Equal, MemoryType, Category>::HashTable(HashTable&& table) :
+	HashTable()
+{
+	*this = std::move(table);
+}
+
+template <typename Key, typename Value, typename KeyOf, typename Hasher, typename Equal, AllocatorMemoryType MemoryType, AllocatorCategory Category>
+inline HashTable<Key, Value, KeyOf, Hasher, Equal, MemoryType, Category>& HashTable<Key, Value, KeyOf, Hasher, Equal, MemoryType, Category>::operator=(const HashTable& table)
+{
+	if (this == &table)
+		return *this;
+	release();
+	m_hasher = table.m_hasher;
+	m_equal = table.m_equal;
+	if (table.m_bucketCount == 0)
+		return *this;
+	// Same layout, so buckets can be copied as is.
+	m_bucketCount = table.m_bucketCount;
+	m_shift = table.m_shift;
+	m_buckets = getAllocator().template allocate<Bucket>(m_bucketCount);
+	m_values = getAllocator().template allocate<Value>(getMaxSize(m_bucketCount));
+	Memory::copy(m_buckets, table.m_buckets, sizeof(Bucket) * m_bucketCount);
+	std::uninitialized_copy(table.begin(), table.end(), m_values);
+	m_size = table.m_size;
+	return *this;
+}
+
+template <typename Key, typename Value, typename KeyOf, typename Hasher, typename Equal, AllocatorMemoryType MemoryType, AllocatorCategory Category>
+inline HashTable<Key, Value, KeyOf, Hasher, Equal, MemoryType, Category>& HashTable<Key, Value, KeyOf, Hasher, Equal, MemoryType, Category>::operator=(HashTable&& table)
+{
+	std::swap(m_values, table.m_values);
+	std::swap(m_buckets, table.m_buckets);
+	std::swap(m_size, table.m_size);
+	std::swap(m_bucketCount, table.m_bucketCount);
+	std::swap(m_shift, table.m_shift);
+	std::swap(m_hasher, table.m_hasher);
+	std::swap(m_equal, table.m_equal);
+	return *this;
+}
+
+template <typename Key, typename Value, typename KeyOf, typename Hasher, typename Equal, AllocatorMemoryType MemoryType, AllocatorCategory Category>
+inline HashTable<Key, Value, KeyOf, Hasher, Equal, MemoryType, Category>::~HashTable()
+{
+	release();
+}
+
+template <typename Key, typename Value, typename KeyOf, typename Hasher, typename Equal, AllocatorMemoryType MemoryType, AllocatorCategory Category>
+inline void HashTable<Key, Value, KeyOf, Hasher, Equal, MemoryType, Category>::clear()
+{
+	std::destroy(begin(), end());
+	if (m_buckets != nullptr)
+		Memory::zero(m_buckets, sizeof(Bucket) * m_bucketCount);
+	m_size = 0;
+}
+
+template <typename Key, typename Value, typename KeyOf, typename Hasher, typename Equal, AllocatorMemoryType MemoryType, AllocatorCategory Category>
+inline void HashTable<Key, Value, KeyOf, Hasher, Equal, MemoryType, Category>::reserve(size_t count)
+{
+	size_t bucketCount = (m_bucketCount > 0) ? m_bucketCount : minBucketCount;
+	while (getMaxSize(bucketCount) < count)
+		bucketCount *= 2;
+	if (bucketCount != m_bucketCount)
+		reallocate(bucketCount);
+}
+
+template <typename Key, typename Value, typename KeyOf, typename Hasher, typename Equal, AllocatorMemoryType MemoryType, AllocatorCategory Category>
+inline typename HashTable<Key, Value, KeyOf, Hasher, Equal, MemoryType, Category>::iterator HashTable<Key, Value, KeyOf, Hasher, Equal, MemoryType, Category>::find(const Key& key)
+{
+	const size_t bucketIndex = findBucket(key);
+	if (bucketIndex == invalidIndex)
+		return end();
+	return m_values + m_buckets[bucketIndex].valueIndex;
+}
+
+template <typename Key, typename Value, typename KeyOf, typename Hasher, typename Equal, AllocatorMemoryType MemoryType, AllocatorCategory Category>
+inline typename HashTable<Key, Value, KeyOf, Hasher, Equal, MemoryType, Category>::const_iterator HashTable<Key, Value, KeyOf, Hasher, Equal, MemoryType, Category>::find(const Key& key) const
+{
+	const size_t bucketIndex = findBucket(key);
+	if (bucketIndex == invalidIndex)
+		return end();
+	return m_values + m_buckets[bucketIndex].valueIndex;
+}
+
+template <typename Key, typename Value, typename KeyOf, typename Hasher, typename Equal, AllocatorMemoryType MemoryType, AllocatorCategory Category>
+inline std::pair<typename HashTable<Key, Value, KeyOf, Hasher, Equal, MemoryType, Category>::iterator, bool> HashTable<Key, Value, KeyOf, Hasher, Equal, MemoryType, Category>::insert(const Value& value)
+{
+	return emplaceKey(KeyOf::get(value), value);
+}
+
+template <typename Key, typename Value, typename KeyOf, typename Hasher, typename Equal, AllocatorMemoryType MemoryType, AllocatorCategory Category>
+inline std::pair<typename HashTable<Key, Value, KeyOf, Hasher, Equal, MemoryType, Category>::iterator, bool> HashTable<Key, Value, KeyOf, Hasher, Equal, MemoryType, Category>::insert(Value&& value)
+{
+	return emplaceKey(KeyOf::get(value), std::move(value));
+}
+
+template <typename Key, typename Value, typename KeyOf, typename Hasher, typename Equal, AllocatorMemoryType MemoryType, AllocatorCategory Category>
+template <typename... Args>
+inline std::pair<typename HashTable<Key, Value, KeyOf, Hasher, Equal, MemoryType, Category>::iterator, bool> HashTable<Key, Value, KeyOf, Hasher, Equal, MemoryType, Category>::emplace(Args&&... args)
+{
+	// Key is only known once value is constructed.
+	Value value(std::forward<Args>(args)...);
+	return insert(std::move(value));
+}
+
+template <typename Key, typename Value, typename KeyOf, typename Hasher, typename Equal, AllocatorMemoryType MemoryType, AllocatorCategory Category>
+template <typename K, typename... Args>
+inline std::pair<typename HashTable<Key, Value, KeyOf, Hasher, Equal, MemoryType, Category>::iterator, bool> HashTable<Key, Value, KeyOf, Hasher, Equal, MemoryType, Category>::emplaceKey(const K& key, Args&&... args)
+{
+	const size_t bucketIndex = findBucket(key);
+	if (bucketIndex != invalidIndex)
+		return std::make_pair(m_values + m_buckets[bucketIndex].valueIndex, false);
+	if (m_size >= getMaxSize(m_bucketCount))
+		reallocate(m_bucketCount > 0 ? m_bucketCount * 2 : minBucketCount);
+	const uint32_t valueIndex = static_cast<uint32_t>(m_size);
+	new (m_values + valueIndex) Value(std::forward<Args>(args)...);
+	m_size++;
+	placeBucket(valueIndex);
+	return std::make_pair(m_values + valueIndex, true);
+}
+
+template <typename Key, typename Value, typename KeyOf, typename Hasher, typename Equal, AllocatorMemoryType MemoryType, AllocatorCategory Category>
+inline size_t HashTable<Key, Value, KeyOf, Hasher, Equal, MemoryType, Category>::erase(const Key& key)
+{
+	const size_t bucketIndex = findBucket(key);
+	if (bucketIndex == invalidIndex)
+		return 0;
+	eraseAt(bucketIndex);
+	return 1;
+}
+
+template <typename Key, typename Value, typename KeyOf, typename Hasher, typename Equal, AllocatorMemoryType MemoryType, AllocatorCategory Category>
+inline typename HashTable<Key, Value, KeyOf, Hasher, Equal, MemoryType, Category>::iterator HashTable<Key, Value, KeyOf, Hasher, Equal, MemoryType, Category>::erase(const_iterator it)
+{
+	AKA_ASSERT(it >= begin() && it < end(), "Invalid iterator");
+	const size_t valueIndex = it - begin();
+	// Find the bucket pointing to this value.
+	size_t bucketIndex = mix(m_hasher(KeyOf::get(*it))) >> m_shift;
+	while (m_buckets[bucketIndex].valueIndex != valueIndex || m_buckets[bucketIndex].distAndFingerprint == 0)
+		bucketIndex = nextBucket(bucketIndex);
+	eraseAt(bucketIndex);
+	// Last value was moved at this position.
+	return m_values + valueIndex;
+}
+
+template <typename Key, typename Value, typename KeyOf, typename Hasher, typename Equal, AllocatorMemoryType MemoryType, AllocatorCategory Category>
+inline uint64_t HashTable<Key, Value, KeyOf, Hasher, Equal, MemoryType, Category>::mix(uint64_t hash)
+{
+	// Murmur3 finalizer
+	hash ^= hash >> 33;
+	hash *= 0xff51afd7ed558ccdULL;
+	hash ^= hash >> 33;
+	hash *= 0xc4ceb9fe1a85ec53ULL;
+	hash ^= hash >> 33;
+	return hash;
+}
+
+template <typename Key, typename Value, typename KeyOf, typename Hasher, typename Equal, AllocatorMemoryType MemoryType, AllocatorCategory Category>
+inline size_t HashTable<Key, Value, KeyOf, Hasher, Equal, MemoryType, Category>::findBucket(const Key& key) const
+{
+	if (m_size == 0)
+		return invalidIndex;
+	const uint64_t hash = mix(m_hasher(key));
+	uint32_t distAndFingerprint = distIncrement | static_cast<uint32_t>(hash & fingerprintMask);
+	size_t bucketIndex = static_cast<size_t>(hash >> m_shift);
+	while (true)
+	{
+		const Bucket& bucket = m_buckets[bucketIndex];
+		if (bucket.distAndFingerprint == distAndFingerprint)
+		{
+			if (m_equal(KeyOf::get(m_values[bucket.valueIndex]), key))
+				return bucketIndex;
+		}
+		else if (bucket.distAndFingerprint < distAndFingerprint)
+		{
+			// Empty bucket or bucket closer to its ideal position than key would be, so key is missing.
+			return invalidIndex;
+		}
+		distAndFingerprint += distIncrement;
+		bucketIndex = nextBucket(bucketIndex);
+	}
+}
+
+template <typename Key, typename Value, typename KeyOf, typename Hasher, typename Equal, AllocatorMemoryType MemoryType, AllocatorCategory Category>
+inline void HashTable<Key, Value, KeyOf, Hasher, Equal, MemoryType, Category>::placeBucket(uint32_t valueIndex)
+{
+	const uint64_t hash = mix(m_hasher(KeyOf::get(m_values[valueIndex])));
+	Bucket bucket{ distIncrement | static_cast<uint32_t>(hash & fingerprintMask), valueIndex };
+	size_t bucketIndex = static_cast<size_t>(hash >> m_shift);
+	// Skip buckets that are further from their ideal position.
+	while (bucket.distAndFingerprint <= m_buckets[bucketIndex].distAndFingerprint)
+	{
+		bucket.distAndFingerprint += distIncrement;
+		bucketIndex = nextBucket(bucketIndex);
+	}
+	// Take the place of a richer bucket & shift following ones up to next empty bucket.
+	while (m_buckets[bucketIndex].distAndFingerprint != 0)
+	{
+		std::swap(bucket, m_buckets[bucketIndex]);
+		bucket.distAndFingerprint += distIncrement;
+		bucketIndex = nextBucket(bucketIndex);
+	}
+	m_buckets[bucketIndex] = bucket;
+}
+
+template <typename Key, typename Value, typename KeyOf, typename Hasher, typename Equal, AllocatorMemoryType MemoryType, AllocatorCategory Category>
+inline void HashTable<Key, Value, KeyOf, Hasher, Equal, MemoryType, Category>::eraseAt(size_t bucketIndex)
+{
+	const uint32_t valueIndex = m_buckets[bucketIndex].valueIndex;
+	// Shift following buckets back until one is empty or at its ideal position.
+	size_t nextIndex = nextBucket(bucketIndex);
+	while (m_buckets[nextIndex].distAndFingerprint >= 2 * distIncrement)
+	{
+		m_buckets[bucketIndex] = Bucket{ m_buckets[nextIndex].distAndFingerprint - distIncrement, m_buckets[nextIndex].valueIndex };
+		bucketIndex = nextIndex;
+		nextIndex = nextBucket(nextIndex);
+	}
+	m_buckets[bucketIndex] = Bucket{ 0, 0 };
+	// Move last value in the hole to keep values dense.
+	const uint32_t lastIndex = static_cast<uint32_t>(m_size - 1);
+	if (valueIndex != lastIndex)
+	{
+		size_t lastBucketIndex = static_cast<size_t>(mix(m_hasher(KeyOf::get(m_values[lastIndex]))) >> m_shift);
+		while (m_buckets[lastBucketIndex].valueIndex != lastIndex || m_buckets[lastBucketIndex].distAndFingerprint == 0)
+			lastBucketIndex = nextBucket(lastBucketIndex);
+		m_buckets[lastBucketIndex].valueIndex = valueIndex;
+		m_values[valueIndex].~Value();
+		new (m_values + valueIndex) Value(std::move(m_values[lastIndex]));
+	}
+	m_values[lastIndex].~Value();
+	m_size--;
+}
+
+template <typename Key, typename Value, typename KeyOf, typename Hasher, typename Equal, AllocatorMemoryType MemoryType, AllocatorCategory Category>
+inline void HashTable<Key, Value, KeyOf, Hasher, Equal, MemoryType, Category>::reallocate(size_t bucketCount)
+{
+	AKA_ASSERT((bucketCount & (bucketCount - 1)) == 0, "Bucket count must be a power of two");
+	AKA_ASSERT(getMaxSize(bucketCount) >= m_size, "Not enough buckets");
+	Allocator& allocator = getAllocator();
+	Value* values = allocator.template allocate<Value>(getMaxSize(bucketCount));
+	std::uninitialized_move(begin(), end(), values);
+	std::destroy(begin(), end());
+	allocator.deallocate(m_values);
+	allocator.deallocate(m_buckets);
+	m_values = values;
+	m_buckets = allocator.template allocate<Bucket>(bucketCount);
+	Memory::zero(m_buckets, sizeof(Bucket) * bucketCount);
+	m_bucketCount = bucketCount;
+	m_shift = 64;
+	for (size_t count = bucketCount; count > 1; count >>= 1)
+		m_shift--;
+	for (uint32_t valueIndex = 0; valueIndex < m_size; valueIndex++)
+		placeBucket(valueIndex);
+}
+
+template <typename Key, typename Value, typename KeyOf, typename Hasher, typename Equal, AllocatorMemoryType MemoryType, AllocatorCategory Category>
+inline void HashTable<Key, Value, KeyOf, Hasher, Equal, MemoryType, Category>::release()
+{
+	std::destroy(begin(), end());
+	Allocator& allocator = getAllocator();
+	allocator.deallocate(m_values);
+	allocator.deallocate(m_buckets);
+	m_values = nullptr;
+	m_buckets = nullptr;
+	m_size = 0;
+	m_bucketCount = 0;
+	m_shift = 64;
+}
+
+template <typename K, typename T, typename Hasher, typename Equal, AllocatorCategory Category>
+inline T& HashMap<K, T, Hasher, Equal, Category>::at(const K& key)
+{
+	iterator it = this->find(key);
+	AKA_ASSERT(it != this->end(), "Key not found");
+	return it->second;
+}
+
+template <typename K, typename T, typename Hasher, typename Equal, AllocatorCategory Category>
+inline const T& HashMap<K, T, Hasher, Equal, Category>::at(const K& key) const
+{
+	const_iterator it = this->find(key);
+	AKA_ASSERT(it != this->end(), "Key not found");
+	return it->second;
+}
+
+template <typename K, typename T, typename Hasher, typename Equal, AllocatorCategory Category>
+template <typename... Args>
+inline std::pair<typename HashMap<K, T, Hasher, Equal, Category>::iterator, bool> HashMap<K, T, Hasher, Equal, Category>::try_emplace(const K& key, Args&&... args)
+{
+	return this->emplaceKey(key, std::piecewise_construct, std::forward_as_tuple(key), std::forward_as_tuple(std::forward<Args>(args)...));
+}
 
-}
\ No newline at end of file
+}
@@ -0,0 +1,221 @@
+#pragma once
+
+#include <atomic>
+#include <stdint.h>
+
+#include <Aka/Core/Config.h>
+
+namespace aka {
+
+// Bounded lock free FIFO queue, for any number of producers & consumers.
+// Each cell has a sequence number telling whether it is ready to be written or read, so that producers
+// & consumers only contend on their own index (Vyukov's bounded queue).
+// Batch operations claim a whole range of cells with a single compare exchange.
+template <typename T, size_t Capacity>
+class MPMCQueue final
+{
+	static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of 2.");
+public:
+	MPMCQueue();
+	MPMCQueue(const MPMCQueue&) = delete;
+	MPMCQueue& operator=(const MPMCQueue&) = delete;
+	~MPMCQueue();
+
+	// Push a value at the end of the queue. Return false if full.
+	bool push(const T& value);
+	// Push a value at the end of the queue. Return false if full.
+	bool push(T&& value);
+	// Push up to count values at the end of the queue, in order. Return the number of values pushed.
+	size_t push(const T* values, size_t count);
+	// Pop a value from the front of the queue. Return false if empty.
+	bool pop(T& value);
+	// Pop up to count values from the front of the queue. Return the number of values popped.
+	size_t pop(T* values, size_t count);
+
+	// Approximate number of values in the queue.
+	size_t size() const;
+	// Check if the queue is approximately empty.
+	bool empty() const;
+	// Maximum number of values in the queue.
+	static constexpr size_t capacity() { return Capacity; }
+private:
+	static constexpr size_t mask = Capacity - 1;
+	// Claim count cells to write, return the first position & update count to the number claimed.
+	size_t claimPush(size_t& count);
+	// Claim count cells to read, return the first position & update count to the number claimed.
+	size_t claimPop(size_t& count);
+private:
+	struct Cell
+	{
+		std::atomic<size_t> sequence; // Equal to position when writable, position + 1 when readable.
+		T value;
+	};
+	// Padding to avoid false sharing between producers & consumers.
+	std::atomic<size_t> m_pushPosition;
+	uint8_t m_paddingPush[64 - sizeof(std::atomic<size_t>)];
+	std::atomic<size_t> m_popPosition;
+	uint8_t m_paddingPop[64 - sizeof(std::atomic<size_t>)];
+	Cell m_cells[Capacity];
+};
+
+template <typename T, size_t Capacity>
+inline MPMCQueue<T, Capacity>::MPMCQueue() :
+	m_pushPosition(0),
+	m_popPosition(0)
+{
+	for (size_t i = 0; i < Capacity; i++)
+		m_cells[i].sequence.store(i, std::memory_order_relaxed);
+}
+
+template <typename T, size_t Capacity>
+inline MPMCQueue<T, Capacity>::~MPMCQueue()
+{
+}
+
+template <typename T, size_t Capacity>
+inline size_t MPMCQueue<T, Capacity>::claimPush(size_t& count)
+{
+	size_t position = m_pushPosition.load(std::memory_order_relaxed);
+	// Nothing to claim, loop below would never find an end.
+	if (count == 0)
+		return position;
+	while (true)
+	{
+		// Count cells writable from position. Only a producer claiming them could change it.
+		size_t writable = 0;
+		while (writable < count && m_cells[(position + writable) & mask].sequence.load(std::memory_order_acquire) == position + writable)
+			writable++;
+		if (writable == 0)
+		{
+			const size_t sequence = m_cells[position & mask].sequence.load(std::memory_order_acquire);
+			if (static_cast<intptr_t>(sequence - position) < 0)
+			{
+				// Full, last value at this cell was not popped yet.
+				count = 0;
+				return position;
+			}
+			// Another producer claimed it, retry further.
+			position = m_pushPosition.load(std::memory_order_relaxed);
+		}
+		else if (m_pushPosition.compare_exchange_weak(position, position + writable, std::memory_order_relaxed))
+		{
+			count = writable;
+			return position;
+		}
+	}
+}
+
+template <typename T, size_t Capacity>
+inline size_t MPMCQueue<T, Capacity>::claimPop(size_t& count)
+{
+	size_t position = m_popPosition.load(std::memory_order_relaxed);
+	// Nothing to claim, loop below would never find an end.
+	if (count == 0)
+		return position;
+	while (true)
+	{
+		// Count cells readable from position. Only a consumer claiming them could change it.
+		size_t readable = 0;
+		while (readable < count && m_cells[(position + readable) & mask].sequence.load(std::memory_order_acquire) == position + readable + 1)
+			readable++;
+		if (readable == 0)
+		{
+			const size_t sequence = m_cells[position & mask].sequence.load(std::memory_order_acquire);
+			if (static_cast<intptr_t>(sequence - (position + 1)) < 0)
+			{
+				// Empty, value at this cell was not pushed yet.
+				count = 0;
+				return position;
+			}
+			// Another consumer claimed it, retry further.
+			position = m_popPosition.load(std::memory_order_relaxed);
+		}
+		else if (m_popPosition.compare_exchange_weak(position, position + readable, std::memory_order_relaxed))
+		{
+			count = readable;
+			return position;
+		}
+	}
+}
+
+template <typename T, size_t Capacity>
+inline bool MPMCQueue<T, Capacity>::push(const T& value)
+{
+	size_t count = 1;
+	const size_t position = claimPush(count);
+	if (count == 0)
+		return false;
+	Cell& cell = m_cells[position & mask];
+	cell.value = value;
+	cell.sequence.store(position + 1, std::memory_order_release);
+	return true;
+}
+
+template <typename T, size_t Capacity>
+inline bool MPMCQueue<T, Capacity>::push(T&& value)
+{
+	size_t count = 1;
+	const size_t position = claimPush(count);
+	if (count == 0)
+		return false;
+	Cell& cell = m_cells[position & mask];
+	cell.value = std::move(value);
+	cell.sequence.store(position + 1, std::memory_order_release);
+	return true;
+}
+
+template <typename T, size_t Capacity>
+inline size_t MPMCQueue<T, Capacity>::push(const T* values, size_t count)
+{
+	const size_t position = claimPush(count);
+	for (size_t i = 0; i < count; i++)
+	{
+		Cell& cell = m_cells[(position + i) & mask];
+		cell.value = values[i];
+		cell.sequence.store(position + i + 1, std::memory_order_release);
+	}
+	return count;
+}
+
+template <typename T, size_t Capacity>
+inline bool MPMCQueue<T, Capacity>::pop(T& value)
+{
+	size_t count = 1;
+	const size_t position = claimPop(count);
+	if (count == 0)
+		return false;
+	Cell& cell = m_cells[position & mask];
+	value = std::move(cell.value);
+	// Cell is writable again on next lap.
+	cell.sequence.store(position + Capacity, std::memory_order_release);
+	return true;
+}
+
+template <typename T, size_t Capacity>
+inline size_t MPMCQueue<T, Capacity>::pop(T* values, size_t count)
+{
+	const size_t position = claimPop(count);
+	for (size_t i = 0; i < count; i++)
+	{
+		Cell& cell = m_cells[(position + i) & mask];
+		values[i] = std::move(cell.value);
+		cell.sequence.store(position + i + Capacity, std::memory_order_release);
+	}
+	return count;
+}
+
+template <typename T, size_t Capacity>
+inline size_t MPMCQueue<T, Capacity>::size() const
+{
+	const size_t pushPosition = m_pushPosition.load(std::memory_order_relaxed);
+	const size_t popPosition = m_popPosition.load(std::memory_order_relaxed);
+	return pushPosition > popPosition ? pushPosition - popPosition : 0;
+}
+
+template <typename T, size_t Capacity>
+inline bool MPMCQueue<T, Capacity>::empty() const
+{
+	return size() == 0;
+}
+
+};
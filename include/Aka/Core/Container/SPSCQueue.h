@@ -0,0 +1,158 @@
+#pragma once
+
+#include <atomic>
+#include <stdint.h>
+
+#include <Aka/Core/Config.h>
+
+namespace aka {
+
+// Bounded lock free FIFO queue, for a single producer thread & a single consumer thread.
+// Each side caches the index of the other one, so that it only touches shared cache lines when it seems full or empty.
+template <typename T, size_t Capacity>
+class SPSCQueue final
+{
+	static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of 2.");
+public:
+	SPSCQueue();
+	SPSCQueue(const SPSCQueue&) = delete;
+	SPSCQueue& operator=(const SPSCQueue&) = delete;
+	~SPSCQueue();
+
+	// Push a value at the end of the queue. Producer thread only. Return false if full.
+	bool push(const T& value);
+	// Push a value at the end of the queue. Producer thread only. Return false if full.
+	bool push(T&& value);
+	// Push up to count values at the end of the queue. Producer thread only. Return the number of values pushed.
+	size_t push(const T* values, size_t count);
+	// Pop a value from the front of the queue. Consumer thread only. Return false if empty.
+	bool pop(T& value);
+	// Pop up to count values from the front of the queue. Consumer thread only. Return the number of values popped.
+	size_t pop(T* values, size_t count);
+
+	// Approximate number of values in the queue.
+	size_t size() const;
+	// Check if the queue is approximately empty.
+	bool empty() const;
+	// Maximum number of values in the queue.
+	static constexpr size_t capacity() { return Capacity; }
+private:
+	static constexpr size_t mask = Capacity - 1;
+	// Get the number of values which can be pushed, up to count.
+	size_t writable(size_t tail, size_t count);
+	// Get the number of values which can be popped, up to count.
+	size_t readable(size_t head, size_t count);
+private:
+	// Padding to avoid false sharing between producer & consumer.
+	std::atomic<size_t> m_tail; // Next position to push, written by producer.
+	size_t m_cachedHead; // Last head seen by producer.
+	uint8_t m_paddingTail[64 - sizeof(std::atomic<size_t>) - sizeof(size_t)];
+	std::atomic<size_t> m_head; // Next position to pop, written by consumer.
+	size_t m_cachedTail; // Last tail seen by consumer.
+	uint8_t m_paddingHead[64 - sizeof(std::atomic<size_t>) - sizeof(size_t)];
+	T m_values[Capacity];
+};
+
+template <typename T, size_t Capacity>
+inline SPSCQueue<T, Capacity>::SPSCQueue() :
+	m_tail(0),
+	m_cachedHead(0),
+	m_head(0),
+	m_cachedTail(0)
+{
+}
+
+template <typename T, size_t Capacity>
+inline SPSCQueue<T, Capacity>::~SPSCQueue()
+{
+}
+
+template <typename T, size_t Capacity>
+inline size_t SPSCQueue<T, Capacity>::writable(size_t tail, size_t count)
+{
+	if (tail - m_cachedHead + count > Capacity)
+		m_cachedHead = m_head.load(std::memory_order_acquire);
+	const size_t free = Capacity - (tail - m_cachedHead);
+	return count < free ? count : free;
+}
+
+template <typename T, size_t Capacity>
+inline size_t SPSCQueue<T, Capacity>::readable(size_t head, size_t count)
+{
+	if (m_cachedTail - head < count)
+		m_cachedTail = m_tail.load(std::memory_order_acquire);
+	const size_t used = m_cachedTail - head;
+	return count < used ? count : used;
+}
+
+template <typename T, size_t Capacity>
+inline bool SPSCQueue<T, Capacity>::push(const T& value)
+{
+	const size_t tail = m_tail.load(std::memory_order_relaxed);
+	if (writable(tail, 1) == 0)
+		return false;
+	m_values[tail & mask] = value;
+	m_tail.store(tail + 1, std::memory_order_release);
+	return true;
+}
+
+template <typename T, size_t Capacity>
+inline bool SPSCQueue<T, Capacity>::push(T&& value)
+{
+	const size_t tail = m_tail.load(std::memory_order_relaxed);
+	if (writable(tail, 1) == 0)
+		return false;
+	m_values[tail & mask] = std::move(value);
+	m_tail.store(tail + 1, std::memory_order_release);
+	return true;
+}
+
+template <typename T, size_t Capacity>
+inline size_t SPSCQueue<T, Capacity>::push(const T* values, size_t count)
+{
+	const size_t tail = m_tail.load(std::memory_order_relaxed);
+	count = writable(tail, count);
+	for (size_t i = 0; i < count; i++)
+		m_values[(tail + i) & mask] = values[i];
+	// Publish all values at once.
+	m_tail.store(tail + count, std::memory_order_release);
+	return count;
+}
+
+template <typename T, size_t Capacity>
+inline bool SPSCQueue<T, Capacity>::pop(T& value)
+{
+	const size_t head = m_head.load(std::memory_order_relaxed);
+	if (readable(head, 1) == 0)
+		return false;
+	value = std::move(m_values[head & mask]);
+	m_head.store(head + 1, std::memory_order_release);
+	return true;
+}
+
+template <typename T, size_t Capacity>
+inline size_t SPSCQueue<T, Capacity>::pop(T* values, size_t count)
+{
+	const size_t head = m_head.load(std::memory_order_relaxed);
+	count = readable(head, count);
+	for (size_t i = 0; i < count; i++)
+		values[i] = std::move(m_values[(head + i) & mask]);
+	m_head.store(head + count, std::memory_order_release);
+	return count;
+}
+
+template <typename T, size_t Capacity>
+inline size_t SPSCQueue<T, Capacity>::size() const
+{
+	const size_t tail = m_tail.load(std::memory_order_relaxed);
+	const size_t head = m_head.load(std::memory_order_relaxed);
+	return tail > head ? tail - head : 0;
+}
+
+template <typename T, size_t Capacity>
+inline bool SPSCQueue<T, Capacity>::empty() const
+{
+	return size() == 0;
+}
+
+};
@@ -0,0 +1,241 @@
+#pragma once
+
+#include <stdint.h>
+
+#include <Aka/Core/Config.h>
+#include <Aka/Core/Container/Vector.h>
+
+namespace aka {
+
+// Handle to an element of a SlotMap.
+// Generation is incremented each time a slot is erased, so that stale handles are detected at lookup.
+template <typename T>
+struct SlotHandle
+{
+	uint32_t index; // Index of the slot
+	uint32_t generation; // Generation of the slot when handle was created. Zero is never used.
+
+	static const SlotHandle<T> null;
+};
+
+template <typename T>
+const SlotHandle<T> SlotHandle<T>::null = { 0, 0 };
+
+template <typename T>
+bool operator==(const SlotHandle<T>& lhs, const SlotHandle<T>& rhs) { return lhs.index == rhs.index && lhs.generation == rhs.generation; }
+template <typename T>
+bool operator!=(const SlotHandle<T>& lhs, const SlotHandle<T>& rhs) { return !(lhs == rhs); }
+
+// Container of elements accessed through generational handles.
+// Elements are stored densely so that iteration is contiguous, they are moved on erase so their address is not stable.
+// Insert, erase & lookup are O(1).
+template <typename T, AllocatorCategory Category = AllocatorCategory::Global>
+class SlotMap final
+{
+public:
+	using Handle = SlotHandle<T>;
+public:
+	SlotMap();
+	SlotMap(const SlotMap&) = delete;
+	SlotMap& operator=(const SlotMap&) = delete;
+	~SlotMap();
+
+	// Insert an element & return its handle
+	template <typename ...Args> Handle insert(Args&&... args);
+	// Erase the element of handle. Return false if handle is stale.
+	bool erase(Handle handle);
+	// Erase all elements. All handles become stale.
+	void clear();
+
+	// Get the element of handle, nullptr if handle is stale.
+	T* get(Handle handle);
+	// Get the element of handle, nullptr if handle is stale.
+	const T* get(Handle handle) const;
+	// Check if handle points to a living element
+	bool isValid(Handle handle) const;
+	// Get the handle of the element at a dense index
+	Handle getHandle(size_t denseIndex) const;
+
+	// Get number of elements
+	size_t size() const;
+	// Check if the map is empty
+	bool empty() const;
+	// Pointer to dense elements
+	T* data();
+	// Pointer to dense elements
+	const T* data() const;
+
+	T* begin();
+	T* end();
+	const T* begin() const;
+	const T* end() const;
+private:
+	static const uint32_t invalidIndex = ~0U;
+	struct Slot
+	{
+		uint32_t index; // Dense index if used, next free slot otherwise.
+		uint32_t generation; // Current generation of the slot.
+	};
+	Vector<T, Category> m_elements; // Dense elements
+	Vector<uint32_t, Category> m_elementSlots; // Slot of each dense element
+	Vector<Slot, Category> m_slots; // Sparse slots
+	uint32_t m_freeSlot; // First free slot
+};
+
+template <typename T, AllocatorCategory Category>
+inline SlotMap<T, Category>::SlotMap() :
+	m_elements(),
+	m_elementSlots(),
+	m_slots(),
+	m_freeSlot(invalidIndex)
+{
+}
+
+template <typename T, AllocatorCategory Category>
+inline SlotMap<T, Category>::~SlotMap()
+{
+}
+
+template <typename T, AllocatorCategory Category>
+template <typename ...Args>
+inline typename SlotMap<T, Category>::Handle SlotMap<T, Category>::insert(Args&&... args)
+{
+	uint32_t slotIndex = m_freeSlot;
+	if (slotIndex == invalidIndex)
+	{
+		slotIndex = static_cast<uint32_t>(m_slots.size());
+		m_slots.append(Slot{ invalidIndex, 1 });
+	}
+	else
+	{
+		m_freeSlot = m_slots[slotIndex].index;
+	}
+	Slot& slot = m_slots[slotIndex];
+	slot.index = static_cast<uint32_t>(m_elements.size());
+	m_elements.emplace(std::forward<Args>(args)...);
+	m_elementSlots.append(slotIndex);
+	return Handle{ slotIndex, slot.generation };
+}
+
+template <typename T, AllocatorCategory Category>
+inline bool SlotMap<T, Category>::erase(Handle handle)
+{
+	if (!isValid(handle))
+		return false;
+	Slot& slot = m_slots[handle.index];
+	const uint32_t denseIndex = slot.index;
+	const uint32_t lastIndex = static_cast<uint32_t>(m_elements.size() - 1);
+	if (denseIndex != lastIndex)
+	{
+		// Move last element in the hole to keep elements dense.
+		m_elements[denseIndex] = std::move(m_elements[lastIndex]);
+		m_elementSlots[denseIndex] = m_elementSlots[lastIndex];
+		m_slots[m_elementSlots[denseIndex]].index = denseIndex;
+	}
+	m_elements.remove(&m_elements.last());
+	m_elementSlots.remove(&m_elementSlots.last());
+	// Invalidate all handles to this slot, skipping zero which is reserved for null.
+	if (++slot.generation == 0)
+		slot.generation = 1;
+	slot.index = m_freeSlot;
+	m_freeSlot = handle.index;
+	return true;
+}
+
+template <typename T, AllocatorCategory Category>
+inline void SlotMap<T, Category>::clear()
+{
+	for (uint32_t denseIndex = 0; denseIndex < m_elementSlots.size(); denseIndex++)
+	{
+		const uint32_t slotIndex = m_elementSlots[denseIndex];
+		Slot& slot = m_slots[slotIndex];
+		if (++slot.generation == 0)
+			slot.generation = 1;
+		slot.index = m_freeSlot;
+		m_freeSlot = slotIndex;
+	}
+	m_elements.clear();
+	m_elementSlots.clear();
+}
+
+template <typename T, AllocatorCategory Category>
+inline T* SlotMap<T, Category>::get(Handle handle)
+{
+	if (!isValid(handle))
+		return nullptr;
+	return &m_elements[m_slots[handle.index].index];
+}
+
+template <typename T, AllocatorCategory Category>
+inline const T* SlotMap<T, Category>::get(Handle handle) const
+{
+	if (!isValid(handle))
+		return nullptr;
+	return &m_elements[m_slots[handle.index].index];
+}
+
+template <typename T, AllocatorCategory Category>
+inline bool SlotMap<T, Category>::isValid(Handle handle) const
+{
+	// Free slots already have the generation of their next use, which no handle can have yet.
+	// Null handle has generation zero, which is never used.
+	return handle.index < m_slots.size() && m_slots[handle.index].generation == handle.generation;
+}
+
+template <typename T, AllocatorCategory Category>
+inline typename SlotMap<T, Category>::Handle SlotMap<T, Category>::getHandle(size_t denseIndex) const
+{
+	AKA_ASSERT(denseIndex < m_elements.size(), "Out of range");
+	const uint32_t slotIndex = m_elementSlots[denseIndex];
+	return Handle{ slotIndex, m_slots[slotIndex].generation };
+}
+
+template <typename T, AllocatorCategory Category>
+inline size_t SlotMap<T, Category>::size() const
+{
+	return m_elements.size();
+}
+
+template <typename T, AllocatorCategory Category>
+inline bool SlotMap<T, Category>::empty() const
+{
+	return m_elements.empty();
+}
+
+template <typename T, AllocatorCategory Category>
+inline T* SlotMap<T, Category>::data()
+{
+	return m_elements.data();
+}
+
+template <typename T, AllocatorCategory Category>
+inline const T* SlotMap<T, Category>::data() const
+{
+	return m_elements.data();
+}
+
+template <typename T, AllocatorCategory Category>
+inline T* SlotMap<T, Category>::begin()
+{
+	return m_elements.begin();
+}
+
+template <typename T, AllocatorCategory Category>
+inline T* SlotMap<T, Category>::end()
+{
+	return m_elements.end();
+}
+
+template <typename T, AllocatorCategory Category>
+inline const T* SlotMap<T, Category>::begin() const
+{
+	return m_elements.begin();
+}
+
+template <typename T, AllocatorCategory Category>
+inline const T* SlotMap<T, Category>::end() const
+{
+	return m_elements.end();
+}
+
+};
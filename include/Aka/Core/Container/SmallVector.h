@@ -0,0 +1,380 @@
+#pragma once
+
+#include <memory>
+
+#include <Aka/Core/Config.h>
+#include <Aka/Memory/Memory.h>
+#include <Aka/Core/Container/Vector.h>
+
+namespace aka {
+
+// Vector storing up to N elements inline, without any allocation.
+// It spills to the vector allocator of its category only when growing beyond N.
+// Elements are moved when the vector is moved, as inline storage cannot be stolen.
+template <typename T, size_t N, AllocatorCategory Category = AllocatorCategory::Global>
+class SmallVector final
+{
+	static_assert(N > 0, "SmallVector needs inline elements, use Vector instead.");
+public:
+	SmallVector();
+	explicit SmallVector(const T* data, size_t size);
+	explicit SmallVector(size_t size, const T& defaultValue);
+	explicit SmallVector(size_t size);
+	SmallVector(const SmallVector& vector);
+	SmallVector(SmallVector&& vector);
+	SmallVector& operator=(const SmallVector& vector);
+	SmallVector& operator=(SmallVector&& vector);
+	~SmallVector();
+
+	T& operator[](size_t index);
+	const T& operator[](size_t index) const;
+
+	bool operator==(const SmallVector& vector) const;
+	bool operator!=(const SmallVector& vector) const;
+
+	T& append(const SmallVector& vector);
+	T& append(const T* start, const T* end);
+	T& append(const T& value);
+	T& append(T&& value);
+	template <typename ...Args>
+	T& emplace(Args&&... args);
+
+	void remove(T* start, T* end);
+	void remove(T* value);
+
+	// Get the size of the vector
+	size_t size() const;
+	// Get the capacity of the vector
+	size_t capacity() const;
+	// Check if elements are stored inline
+	bool isInline() const;
+	// Resize the vector
+	void resize(size_t size);
+	// Resize the vector with default value
+	void resize(size_t size, const T& defaultValue);
+	// Resize the vector capacity
+	void reserve(size_t size);
+	// Empty the vector, keeping its capacity
+	void clear();
+	// Check if vector empty
+	bool empty() const;
+
+	// Pointer to the vector
+	T* data();
+	// Pointer to the vector
+	const T* data() const;
+	// First element of vector
+	T& first();
+	// First element of vector
+	const T& first() const;
+	// Last element of vector
+	T& last();
+	// Last element of vector
+	const T& last() const;
+
+	// Pointer to beginning of vector
+	T* begin();
+	// Pointer to ending of vector
+	T* end();
+	// Pointer to beginning of vector
+	const T* begin() const;
+	// Pointer to ending of vector
+	const T* end() const;
+private:
+	T* getInline() { return reinterpret_cast<T*>(m_inline); }
+	const T* getInline() const { return reinterpret_cast<const T*>(m_inline); }
+	Allocator& getAllocator() const { return mem::getAllocator(AllocatorMemoryType::Vector, Category); }
+private:
+	T* m_data;
+	size_t m_size;
+	size_t m_capacity;
+	alignas(T) uint8_t m_inline[N * sizeof(T)];
+};
+
+template <typename T, size_t N, AllocatorCategory Category>
+inline SmallVector<T, N, Category>::SmallVector() :
+	m_data(getInline()),
+	m_size(0),
+	m_capacity(N)
+{
+}
+template <typename T, size_t N, AllocatorCategory Category>
+inline SmallVector<T, N, Category>::SmallVector(const T* data, size_t size) :
+	SmallVector()
+{
+	append(data, data + size);
+}
+template <typename T, size_t N, AllocatorCategory Category>
+inline SmallVector<T, N, Category>::SmallVector(size_t size, const T& value) :
+	SmallVector()
+{
+	resize(size, value);
+}
+template <typename T, size_t N, AllocatorCategory Category>
+inline SmallVector<T, N, Category>::SmallVector(size_t size) :
+	SmallVector()
+{
+	resize(size);
+}
+template <typename T, size_t N, AllocatorCategory Category>
+inline SmallVector<T, N, Category>::SmallVector(const SmallVector& vector) :
+	SmallVector()
+{
+	append(vector.begin(), vector.end());
+}
+template <typename T, size_t N, AllocatorCategory Category>
+inline SmallVector<T, N, Category>::SmallVector(SmallVector&& vector) :
+	SmallVector()
+{
+	*this = std::move(vector);
+}
+template <typename T, size_t N, AllocatorCategory Category>
+inline SmallVector<T, N, Category>& SmallVector<T, N, Category>::operator=(const SmallVector& vector)
+{
+	if (this == &vector)
+		return *this;
+	clear();
+	append(vector.begin(), vector.end());
+	return *this;
+}
+template <typename T, size_t N, AllocatorCategory Category>
+inline SmallVector<T, N, Category>& SmallVector<T, N, Category>::operator=(SmallVector&& vector)
+{
+	if (this == &vector)
+		return *this;
+	clear();
+	if (vector.isInline())
+	{
+		// Inline elements cannot be stolen, move them one by one.
+		std::uninitialized_move(vector.begin(), vector.end(), end());
+		m_size = vector.m_size;
+		vector.clear();
+	}
+	else
+	{
+		if (!isInline())
+			getAllocator().deallocate(m_data);
+		m_data = vector.m_data;
+		m_size = vector.m_size;
+		m_capacity = vector.m_capacity;
+		vector.m_data = vector.getInline();
+		vector.m_size = 0;
+		vector.m_capacity = N;
+	}
+	return *this;
+}
+template <typename T, size_t N, AllocatorCategory Category>
+inline SmallVector<T, N, Category>::~SmallVector()
+{
+	std::destroy(begin(), end());
+	if (!isInline())
+		getAllocator().deallocate(m_data);
+}
+template <typename T, size_t N, AllocatorCategory Category>
+inline T& SmallVector<T, N, Category>::operator[](size_t index)
+{
+	AKA_ASSERT(index < m_size, "Out of range");
+	return m_data[index];
+}
+template <typename T, size_t N, AllocatorCategory Category>
+inline const T& SmallVector<T, N, Category>::operator[](size_t index) const
+{
+	AKA_ASSERT(index < m_size, "Out of range");
+	return m_data[index];
+}
+template <typename T, size_t N, AllocatorCategory Category>
+inline bool SmallVector<T, N, Category>::operator==(const SmallVector& value) const
+{
+	return (size() == value.size()) && std::equal(begin(), end(), value.begin());
+}
+template <typename T, size_t N, AllocatorCategory Category>
+inline bool SmallVector<T, N, Category>::operator!=(const SmallVector& value) const
+{
+	return !(*this == value);
+}
+template <typename T, size_t N, AllocatorCategory Category>
+inline T& SmallVector<T, N, Category>::append(const SmallVector& vector)
+{
+	return append(vector.begin(), vector.end());
+}
+template <typename T, size_t N, AllocatorCategory Category>
+inline T& SmallVector<T, N, Category>::append(const T* _start, const T* _end)
+{
+	AKA_ASSERT(_end >= _start, "Invalid range");
+	size_t range = (_end - _start);
+	reserve(m_size + range);
+	std::uninitialized_copy(_start, _end, end());
+	m_size += range;
+	return last();
+}
+template <typename T, size_t N, AllocatorCategory Category>
+inline T& SmallVector<T, N, Category>::append(const T& value)
+{
+	return emplace(value);
+}
+template <typename T, size_t N, AllocatorCategory Category>
+inline T& SmallVector<T, N, Category>::append(T&& value)
+{
+	return emplace(std::move(value));
+}
+template <typename T, size_t N, AllocatorCategory Category>
+template <typename ...Args>
+inline T& SmallVector<T, N, Category>::emplace(Args&&... args)
+{
+	if (m_size == m_capacity)
+	{
+		// Value might be an element of this vector, construct it before growing.
+		T value(std::forward<Args>(args)...);
+		reserve(m_size + 1);
+		new (end()) T(std::move(value));
+	}
+	else
+	{
+		new (end()) T(std::forward<Args>(args)...);
+	}
+	m_size++;
+	return last();
+}
+template <typename T, size_t N, AllocatorCategory Category>
+inline void SmallVector<T, N, Category>::remove(T* _start, T* _end)
+{
+	AKA_ASSERT(_start >= begin() && _start <= end(), "Start not in range");
+	AKA_ASSERT(_end >= begin() && _end <= end(), "End not in range");
+	AKA_ASSERT(_end >= _start, "Invalid range");
+	std::move(_end, end(), _start);
+	std::destroy(_start + (end() - _end), end());
+	m_size -= (_end - _start);
+}
+template <typename T, size_t N, AllocatorCategory Category>
+inline void SmallVector<T, N, Category>::remove(T* value)
+{
+	remove(value, value + 1);
+}
+template <typename T, size_t N, AllocatorCategory Category>
+inline size_t SmallVector<T, N, Category>::size() const
+{
+	return m_size;
+}
+template <typename T, size_t N, AllocatorCategory Category>
+inline size_t SmallVector<T, N, Category>::capacity() const
+{
+	return m_capacity;
+}
+template <typename T, size_t N, AllocatorCategory Category>
+inline bool SmallVector<T, N, Category>::isInline() const
+{
+	return m_data == getInline();
+}
+template <typename T, size_t N, AllocatorCategory Category>
+inline void SmallVector<T, N, Category>::resize(size_t size)
+{
+	reserve(size);
+	if (m_size < size)
+		std::uninitialized_default_construct(end(), m_data + size);
+	else
+		std::destroy(m_data + size, end());
+	m_size = size;
+}
+template <typename T, size_t N, AllocatorCategory Category>
+inline void SmallVector<T, N, Category>::resize(size_t size, const T& defaultValue)
+{
+	reserve(size);
+	if (m_size < size)
+		std::uninitialized_fill(end(), m_data + size, defaultValue);
+	else
+		std::destroy(m_data + size, end());
+	m_size = size;
+}
+template <typename T, size_t N, AllocatorCategory Category>
+inline void SmallVector<T, N, Category>::reserve(size_t size)
+{
+	if (size <= m_capacity)
+		return;
+	size_t newCapacity = VectorGrowthPolicy<T>::grow(m_capacity, size);
+	if constexpr (IsTriviallyRelocatable<T>::value)
+	{
+		if (!isInline())
+		{
+			// Let the allocator grow the block in place or memcpy it.
+			m_data = getAllocator().template reallocate<T>(m_data, newCapacity);
+			m_capacity = newCapacity;
+			return;
+		}
+		T* buffer = getAllocator().template allocate<T>(newCapacity);
+		Memory::copy(buffer, m_data, m_size * sizeof(T));
+		m_data = buffer;
+	}
+	else
+	{
+		T* buffer = getAllocator().template allocate<T>(newCapacity);
+		std::uninitialized_move(begin(), end(), buffer);
+		std::destroy(begin(), end());
+		if (!isInline())
+			getAllocator().deallocate(m_data);
+		m_data = buffer;
+	}
+	m_capacity = newCapacity;
+}
+template <typename T, size_t N, AllocatorCategory Category>
+inline void SmallVector<T, N, Category>::clear()
+{
+	std::destroy(begin(), end());
+	m_size = 0;
+}
+template <typename T, size_t N, AllocatorCategory Category>
+inline bool SmallVector<T, N, Category>::empty() const
+{
+	return m_size == 0;
+}
+template <typename T, size_t N, AllocatorCategory Category>
+inline T* SmallVector<T, N, Category>::data()
+{
+	return m_data;
+}
+template <typename T, size_t N, AllocatorCategory Category>
+inline const T* SmallVector<T, N, Category>::data() const
+{
+	return m_data;
+}
+template <typename T, size_t N, AllocatorCategory Category>
+inline T& SmallVector<T, N, Category>::first()
+{
+	return m_data[0];
+}
+template <typename T, size_t N, AllocatorCategory Category>
+inline const T& SmallVector<T, N, Category>::first() const
+{
+	return m_data[0];
+}
+template <typename T, size_t N, AllocatorCategory Category>
+inline T& SmallVector<T, N, Category>::last()
+{
+	return m_data[m_size - 1];
+}
+template <typename T, size_t N, AllocatorCategory Category>
+inline const T& SmallVector<T, N, Category>::last() const
+{
+	return m_data[m_size - 1];
+}
+template <typename T, size_t N, AllocatorCategory Category>
+inline T* SmallVector<T, N, Category>::begin()
+{
+	return m_data;
+}
+template <typename T, size_t N, AllocatorCategory Category>
+inline T* SmallVector<T, N, Category>::end()
+{
+	return m_data + m_size;
+}
+template <typename T, size_t N, AllocatorCategory Category>
+inline const T* SmallVector<T, N, Category>::begin() const
+{
+	return m_data;
+}
+template <typename T, size_t N, AllocatorCategory Category>
+inline const T* SmallVector<T, N, Category>::end() const
+{
+	return m_data + m_size;
+}
+
+};
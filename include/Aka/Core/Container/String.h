@@ -11,10 +11,12 @@
 
 namespace aka {
 
+// String with small string optimization.
+// Strings shorter than the inline capacity are stored inline & only longer ones are allocated.
 template <typename T = char, AllocatorCategory Category = AllocatorCategory::Global>
 class Str final
 {
-	static const size_t defaultCapacity = 16;
+	static const size_t inlineCapacity = 24; // Including null terminator
 public:
 	using Char = T;
 	static const size_t invalid = -1;
@@ -63,6 +65,8 @@ public:
 	size_t size() const;
 	// Get the capacity of the string
 	size_t capacity() const;
+	// Check if string is stored inline
+	bool isInline() const;
 	// Resize the string
 	void resize(size_t length);
 	// Resize the string capacity
@@ -121,11 +125,19 @@ public:
 	// Create a new string from start to end
 	Str substr(size_t start, size_t len) const;
 
+private:
+	// Allocate storage for capacity characters, inline if it fits.
+	T* allocate(size_t capacity);
+	// Release storage if it is not inline.
+	void deallocate();
+	// Take the storage of a string, copying it if inline.
+	void steal(Str& string);
 private:
 	Allocator& m_allocator;
-	T* m_string;
+	T* m_string; // Point to m_inline when inline
 	size_t m_length;
 	size_t m_capacity;
+	T m_inline[inlineCapacity];
 };
 
 using String = Str<char>;
@@ -156,9 +168,9 @@ inline Str<T, Category>::Str(const T* str, Allocator& allocator) :
 template<typename T, AllocatorCategory Category>
 inline Str<T, Category>::Str(const T* str, size_t length, Allocator& allocator) :
 	m_allocator(allocator),
-	m_string(m_allocator.allocate<T>(max(length + 1, defaultCapacity))),
+	m_string(allocate(length + 1)),
 	m_length(length),
-	m_capacity(max(length + 1, defaultCapacity))
+	m_capacity(max(length + 1, inlineCapacity))
 {
 	Str<T, Category>::copy(m_string, m_length, str);
 	m_string[length] = '\0';
@@ -166,9 +178,9 @@ inline Str<T, Category>::Str(const T* str, size_t length, Allocator& allocator)
 template<typename T, AllocatorCategory Category>
 inline Str<T, Category>::Str(size_t length, T character, Allocator& allocator) :
 	m_allocator(allocator),
-	m_string(m_allocator.allocate<T>(max(length + 1, defaultCapacity))),
+	m_string(allocate(length + 1)),
 	m_length(length),
-	m_capacity(max(length + 1, defaultCapacity))
+	m_capacity(max(length + 1, inlineCapacity))
 {
 	for (size_t i = 0; i < length; i++)
 		m_string[i] = character;
@@ -177,9 +189,9 @@ inline Str<T, Category>::Str(size_t length, T character, Allocator& allocator) :
 template<typename T, AllocatorCategory Category>
 inline Str<T, Category>::Str(size_t length, Allocator& allocator) :
 	m_allocator(allocator),
-	m_string(m_allocator.allocate<T>(max(length + 1, defaultCapacity))),
+	m_string(allocate(length + 1)),
 	m_length(length),
-	m_capacity(max(length + 1, defaultCapacity))
+	m_capacity(max(length + 1, inlineCapacity))
 {
 }
 template<typename T, AllocatorCategory Category>
@@ -190,14 +202,12 @@ inline Str<T, Category>::Str(const Str<T, Category>& str, Allocator& allocator)
 template<typename T, AllocatorCategory Category>
 inline Str<T, Category>::Str(Str<T, Category>&& string, Allocator& allocator) :
 	m_allocator(allocator),
-	m_string(nullptr),
+	m_string(m_inline),
 	m_length(0),
-	m_capacity(0)
+	m_capacity(inlineCapacity)
 {
-	//std::swap(m_allocator, string.m_allocator);
-	std::swap(m_string, string.m_string);
-	std::swap(m_length, string.m_length);
-	std::swap(m_capacity, string.m_capacity);
+	m_inline[0] = '\0';
+	steal(string);
 }
 template<typename T, AllocatorCategory Category>
 inline Str<T, Category>& Str<T, Category>::operator=(const Str<T, Category>& str)
@@ -209,10 +219,8 @@ inline Str<T, Category>& Str<T, Category>::operator=(const Str<T, Category>& str
 template<typename T, AllocatorCategory Category>
 inline Str<T, Category>& Str<T, Category>::operator=(Str<T, Category>&& str)
 {
-	//std::swap(m_allocator, str.m_allocator);
-	std::swap(m_string, str.m_string);
-	std::swap(m_length, str.m_length);
-	std::swap(m_capacity, str.m_capacity);
+	if (this != &str)
+		steal(str);
 	return *this;
 }
 template<typename T, AllocatorCategory Category>
@@ -226,7 +234,7 @@ inline Str<T, Category>& Str<T, Category>::operator=(const T* str)
 template<typename T, AllocatorCategory Category>
 inline Str<T, Category>::~Str()
 {
-	m_allocator.deallocate(m_string);
+	deallocate();
 }
 template<typename T, AllocatorCategory Category>
 inline T& Str<T, Category>::operator[](size_t index)
@@ -370,6 +378,11 @@ inline size_t Str<T, Category>::capacity() const
 	return m_capacity;
 }
 template<typename T, AllocatorCategory Category>
+inline bool Str<T, Category>::isInline() const
+{
+	return m_string == m_inline;
+}
+template<typename T, AllocatorCategory Category>
 inline void Str<T, Category>::resize(size_t length)
 {
 	if (m_length == length)
@@ -383,14 +396,49 @@ inline void Str<T, Category>::reserve(size_t size)
 	if (size <= m_capacity)
 		return;
 	size_t oldCapacity = m_capacity;
-	size_t newCapacity = max(size, defaultCapacity);
+	size_t newCapacity = size;
 	T* buffer = m_allocator.allocate<T>(newCapacity);
 	Str<T, Category>::copy(buffer, oldCapacity, m_string);
-	m_allocator.deallocate(m_string);
+	deallocate();
 	m_capacity = newCapacity;
 	m_string = buffer;
 }
 template<typename T, AllocatorCategory Category>
+inline T* Str<T, Category>::allocate(size_t capacity)
+{
+	if (capacity <= inlineCapacity)
+		return m_inline;
+	return m_allocator.allocate<T>(capacity);
+}
+template<typename T, AllocatorCategory Category>
+inline void Str<T, Category>::deallocate()
+{
+	if (!isInline())
+		m_allocator.deallocate(m_string);
+}
+template<typename T, AllocatorCategory Category>
+inline void Str<T, Category>::steal(Str<T, Category>& str)
+{
+	if (str.isInline())
+	{
+		// Inline storage cannot be stolen, copy it.
+		resize(str.m_length);
+		Str<T, Category>::copy(m_string, str.m_length, str.m_string);
+		m_string[m_length] = '\0';
+	}
+	else
+	{
+		deallocate();
+		m_string = str.m_string;
+		m_length = str.m_length;
+		m_capacity = str.m_capacity;
+		str.m_string = str.m_inline;
+		str.m_capacity = inlineCapacity;
+	}
+	str.m_length = 0;
+	str.m_string[0] = '\0';
+}
+template<typename T, AllocatorCategory Category>
 inline void Str<T, Category>::clear()
 {
 	m_length = 0;
@@ -611,6 +659,6 @@ struct std::hash<aka::String>
 {
 	size_t operator()(const aka::String& string) const
 	{
-		return aka::hash::fnv(string.cstr(), string.length());
+		return aka::hash::buffer(string.cstr(), string.length());
 	}
 };
\ No newline at end of file
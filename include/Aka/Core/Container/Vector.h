@@ -1,6 +1,7 @@
 #pragma once
 
 #include <memory>
+#include <type_traits>
 
 #include <Aka/Core/Config.h>
 #include <Aka/Memory/Memory.h>
@@ -13,6 +14,28 @@ namespace aka {
 template <typename T, AllocatorCategory Category = AllocatorCategory::Global>
 using vector = ::std::vector<T, AkaStlAllocator<T, AllocatorMemoryType::Vector, Category>>;
 
+// Types which can be moved in memory with memcpy, without calling move constructor & destructor.
+// Trivially copyable types are, other types can opt in by specializing this trait.
+// Types pointing to themselves, such as small buffer containers, must not.
+template <typename T>
+struct IsTriviallyRelocatable : std::is_trivially_copyable<T> {};
+
+// Growth of vector capacity when it is full, as a ratio of its current capacity.
+// Specialize it to change growth of a type.
+template <typename T>
+struct VectorGrowthPolicy
+{
+	static constexpr size_t numerator = 3;
+	static constexpr size_t denominator = 2;
+
+	// Get the capacity to grow to, to store at least size elements.
+	static size_t grow(size_t capacity, size_t size)
+	{
+		const size_t newCapacity = capacity * numerator / denominator;
+		return (newCapacity < size) ? size : newCapacity; // insufficient growth.
+	}
+};
+
 template <typename T, AllocatorCategory Category = AllocatorCategory::Global>
 class Vector final
 {
@@ -92,6 +115,10 @@ private:
 	size_t m_capacity;
 };
 
+// Vector does not point to itself.
+template <typename T, AllocatorCategory Category>
+struct IsTriviallyRelocatable<Vector<T, Category>> : std::true_type {};
+
 template <typename T, AllocatorCategory Category>
 inline Vector<T, Category>::Vector() :
 	Vector(mem::getAllocator(AllocatorMemoryType::Vector, Category))
@@ -323,15 +350,24 @@ inline void Vector<T, Category>::reserve(size_t size)
 {
 	if (size <= m_capacity)
 		return;
-	size_t oldCapacity = m_capacity;
-	size_t newCapacity = oldCapacity + oldCapacity / 2; // * 1.5 growth
-	if (newCapacity < size)
-		newCapacity = size; // insufficient growth.
-	T* buffer = m_allocator.allocate<T>(newCapacity);
-	std::uninitialized_move(begin(), end(), buffer);
-	m_allocator.deallocate(m_data);
+	size_t newCapacity = VectorGrowthPolicy<T>::grow(m_capacity, size);
+	if constexpr (IsTriviallyRelocatable<T>::value)
+	{
+		// Let the allocator grow the block in place or memcpy it.
+		if (m_data != nullptr)
+			m_data = m_allocator.reallocate<T>(m_data, newCapacity);
+		else
+			m_data = m_allocator.allocate<T>(newCapacity);
+	}
+	else
+	{
+		T* buffer = m_allocator.allocate<T>(newCapacity);
+		std::uninitialized_move(begin(), end(), buffer);
+		std::destroy(begin(), end());
+		m_allocator.deallocate(m_data);
+		m_data = buffer;
+	}
 	m_capacity = newCapacity;
-	m_data = buffer;
 }
 template <typename T, AllocatorCategory Category>
 inline void Vector<T, Category>::clear()
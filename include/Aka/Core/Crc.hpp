@@ -24,10 +24,11 @@ template <unsigned c> struct f<c, 0> { enum { value = c }; };
 constexpr unsigned crc_table[] = { A(0) };
 
 // Constexpr implementation and helpers
+// Iterative so that long strings do not hit the constexpr recursion limit.
 constexpr uint32_t crc32_impl(const char* p, size_t len, uint32_t crc) {
-	return len ?
-		crc32_impl(p + 1, len - 1, (crc >> 8) ^ crc_table[(crc & 0xFF) ^ *p])
-		: crc;
+	for (size_t i = 0; i < len; i++)
+		crc = (crc >> 8) ^ crc_table[(crc & 0xFF) ^ static_cast<uint8_t>(p[i])];
+	return crc;
 }
 
 constexpr uint32_t crc32(const char* data, size_t length) {
@@ -35,11 +36,23 @@ constexpr uint32_t crc32(const char* data, size_t length) {
 }
 
 constexpr size_t strlen_c(const char* str) {
-	return *str ? 1 + strlen_c(str + 1) : 0;
+	size_t length = 0;
+	while (str[length] != '\0')
+		length++;
+	return length;
 }
 
 constexpr uint32_t WSID(const char* str) {
 	return crc32(str, strlen_c(str));
 }
 
+// Runtime implementation, bit identical to crc32 but processing 8 bytes at a time.
+// Use ARMv8 CRC32 instructions when available & slicing by 8 otherwise.
+// SSE4.2 crc32 instruction is not used as it computes CRC32C, which has another polynomial.
+// Previous result can be passed as crc to process data in several parts.
+uint32_t crc32_runtime(const void* data, size_t length, uint32_t crc = 0);
+
+// Runtime WSID, for names only known at runtime.
+uint32_t WSID_runtime(const char* str);
+
 }
\ No newline at end of file
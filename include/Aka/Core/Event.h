@@ -2,6 +2,7 @@
 
 #include <Aka/Core/Container/String.h>
 #include <Aka/Core/Container/HashMap.hpp>
+#include <Aka/Core/Container/SmallVector.h>
 
 namespace aka {
 
@@ -35,6 +36,9 @@ public:
 	static void unsubscribe(EventListener<T>* listener);
 	// Unsubscribe all listeners from event
 	static void unsubscribe();
+private:
+	// Send an event to listeners subscribed before the call & still subscribed.
+	static void send(const T& event);
 private:
 	static Vector<T> m_events;
 	static HashSet<EventListener<T>*> m_listeners;
@@ -64,18 +68,28 @@ inline void EventDispatcher<T>::emit(Args&&... args)
 template <typename T>
 inline void EventDispatcher<T>::trigger(T&& event)
 {
-	for (EventListener<T>* listener : m_listeners)
-		listener->onReceive(event);
+	send(event);
 }
 template <typename T>
 inline void EventDispatcher<T>::dispatch()
 {
 	for (T& event : m_events)
-		for (EventListener<T>* listener : m_listeners)
-			listener->onReceive(event);
+		send(event);
 	m_events.clear();
 }
 template <typename T>
+inline void EventDispatcher<T>::send(const T& event)
+{
+	// Erasing a listener move another one in its place, so iterate over a copy.
+	// Listeners unsubscribed by previous ones while receiving are skipped.
+	SmallVector<EventListener<T>*, 16> listeners;
+	for (EventListener<T>* listener : m_listeners)
+		listeners.append(listener);
+	for (EventListener<T>* listener : listeners)
+		if (m_listeners.contains(listener))
+			listener->onReceive(event);
+}
+template <typename T>
 inline void EventDispatcher<T>::clear()
 {
 	m_events.clear();
@@ -12,11 +12,142 @@ namespace hash {
 void fnv(size_t& hash, const void* data, size_t size);
 size_t fnv(const void* data, size_t size);
 
-// Combine two hash using Fowler noll vo hash
+// Wyhash (final version 4), hashing data 8 bytes at a time. Not cryptographic.
+uint64_t wyhash(const void* data, size_t size, uint64_t seed = 0);
+
+// Compile time wyhash for string literals, result is identical to wyhash on little endian platforms.
+constexpr uint64_t wyhash_c(const char* data, size_t size, uint64_t seed = 0);
+// Compile time wyhash for null terminated string literals.
+constexpr uint64_t wyhash_c(const char* str);
+
+// Streaming wyhash, for data that is not contiguous in memory.
+// Digest is identical to wyhash of all data updated, whatever how it is split.
+class WyhashState
+{
+public:
+	WyhashState(uint64_t seed = 0);
+
+	// Hash some more data
+	void update(const void* data, size_t size);
+	// Get the hash of all data updated since construction
+	uint64_t digest() const;
+private:
+	static constexpr size_t BlockSize = 48;
+	static constexpr size_t HistorySize = 16;
+	uint64_t m_seed; // Seed as given by user
+	uint64_t m_state[3]; // State of the three lanes of blocks
+	size_t m_length; // Total length updated
+	size_t m_pendingSize; // Size of pending data, not processed yet.
+	uint8_t m_buffer[HistorySize + BlockSize]; // Last bytes of previous block, followed by pending data.
+};
+
+// Hash a buffer with the default backend, wyhash unless AKA_HASH_BACKEND_FNV is defined.
+// This is for in memory hashing only, as result depend on backend & might change between versions.
+size_t buffer(const void* data, size_t size, size_t seed = 0);
+
+// Combine a value into a hash, using the default backend.
 template <typename T> void combine(std::size_t& s, const T& v)
 {
-	fnv(s, &v, sizeof(T));
+	s = buffer(&v, sizeof(T), s);
+}
+
+namespace detail {
+
+constexpr uint64_t WyhashSecret[4] = { 0xa0761d6478bd642fULL, 0xe7037ed1a0b428dbULL, 0x8ebc6af09c88c6e3ULL, 0x589965cc75374cc3ULL };
+
+// 64x64 -> 128 bits multiply with 32 bits halves, for compile time evaluation.
+constexpr void wymum_c(uint64_t& a, uint64_t& b)
+{
+	const uint64_t ha = a >> 32, hb = b >> 32, la = static_cast<uint32_t>(a), lb = static_cast<uint32_t>(b);
+	const uint64_t rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb, t = rl + (rm0 << 32);
+	uint64_t c = t < rl;
+	const uint64_t lo = t + (rm1 << 32);
+	c += lo < t;
+	const uint64_t hi = rh + (rm0 >> 32) + (rm1 >> 32) + c;
+	a = lo;
+	b = hi;
+}
+constexpr uint64_t wymix_c(uint64_t a, uint64_t b)
+{
+	wymum_c(a, b);
+	return a ^ b;
+}
+constexpr uint64_t wyr8_c(const char* p)
+{
+	uint64_t v = 0;
+	for (size_t i = 0; i < 8; i++)
+		v |= static_cast<uint64_t>(static_cast<uint8_t>(p[i])) << (8 * i);
+	return v;
+}
+constexpr uint64_t wyr4_c(const char* p)
+{
+	uint64_t v = 0;
+	for (size_t i = 0; i < 4; i++)
+		v |= static_cast<uint64_t>(static_cast<uint8_t>(p[i])) << (8 * i);
+	return v;
+}
+constexpr uint64_t wyr3_c(const char* p, size_t k)
+{
+	return (static_cast<uint64_t>(static_cast<uint8_t>(p[0])) << 16) | (static_cast<uint64_t>(static_cast<uint8_t>(p[k >> 1])) << 8) | static_cast<uint8_t>(p[k - 1]);
+}
+
+};
+
+constexpr uint64_t wyhash_c(const char* p, size_t size, uint64_t seed)
+{
+	using namespace detail;
+	seed ^= wymix_c(seed ^ WyhashSecret[0], WyhashSecret[1]);
+	uint64_t a = 0, b = 0;
+	if (size <= 16)
+	{
+		if (size >= 4)
+		{
+			a = (wyr4_c(p) << 32) | wyr4_c(p + ((size >> 3) << 2));
+			b = (wyr4_c(p + size - 4) << 32) | wyr4_c(p + size - 4 - ((size >> 3) << 2));
+		}
+		else if (size > 0)
+		{
+			a = wyr3_c(p, size);
+		}
+	}
+	else
+	{
+		size_t i = size;
+		if (i > 48)
+		{
+			uint64_t see1 = seed, see2 = seed;
+			do
+			{
+				seed = wymix_c(wyr8_c(p) ^ WyhashSecret[1], wyr8_c(p + 8) ^ seed);
+				see1 = wymix_c(wyr8_c(p + 16) ^ WyhashSecret[2], wyr8_c(p + 24) ^ see1);
+				see2 = wymix_c(wyr8_c(p + 32) ^ WyhashSecret[3], wyr8_c(p + 40) ^ see2);
+				p += 48;
+				i -= 48;
+			} while (i > 48);
+			seed ^= see1 ^ see2;
+		}
+		while (i > 16)
+		{
+			seed = wymix_c(wyr8_c(p) ^ WyhashSecret[1], wyr8_c(p + 8) ^ seed);
+			i -= 16;
+			p += 16;
+		}
+		a = wyr8_c(p + i - 16);
+		b = wyr8_c(p + i - 8);
+	}
+	a ^= WyhashSecret[1];
+	b ^= seed;
+	wymum_c(a, b);
+	return wymix_c(a ^ WyhashSecret[0] ^ size, b ^ WyhashSecret[1]);
+}
+
+constexpr uint64_t wyhash_c(const char* str)
+{
+	size_t size = 0;
+	while (str[size] != '\0')
+		size++;
+	return wyhash_c(str, size, 0);
 }
 
 }; // namespace hash
-}; // namespace aka
\ No newline at end of file
+}; // namespace aka
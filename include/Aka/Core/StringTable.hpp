@@ -0,0 +1,90 @@
+#pragma once
+
+#include <atomic>
+#include <shared_mutex>
+
+#include <Aka/Core/Config.h>
+#include <Aka/Core/Container/String.h>
+#include <Aka/Core/Container/Vector.h>
+#include <Aka/Core/Container/HashMap.hpp>
+
+namespace aka {
+
+// Compact ID of an interned string, equal for equal strings.
+// IDs are only stable during a run, serialize the string instead.
+enum class StringID : uint32_t { Empty = 0 };
+
+// Table of interned strings.
+// Each distinct string is stored once & stays valid until the table is destroyed.
+// It is thread safe. Interning take a shared lock unless the string is new, reverse lookup is lock free.
+class StringTable
+{
+public:
+	StringTable();
+	StringTable(const StringTable&) = delete;
+	StringTable& operator=(const StringTable&) = delete;
+	~StringTable();
+
+	// Intern a null terminated string & return its ID
+	StringID intern(const char* string);
+	// Intern a string & return its ID
+	StringID intern(const char* string, size_t length);
+	// Intern a string & return its ID
+	StringID intern(const String& string);
+	// Find the ID of a string without interning it. Return false if it was never interned.
+	bool find(const char* string, size_t length, StringID& id) const;
+
+	// Get the null terminated string of an ID
+	const char* getString(StringID id) const;
+	// Get the length of the string of an ID
+	size_t getLength(StringID id) const;
+	// Get the number of interned strings
+	size_t size() const;
+	// Get the memory used to store strings
+	size_t getUsedMemory() const;
+private:
+	static constexpr size_t PageSize = 1024; // Entries per page
+	static constexpr size_t PageCount = 4096; // Maximum number of pages
+	static constexpr size_t BlockSize = 64 * 1024; // Size of blocks storing characters
+	struct Entry
+	{
+		const char* string;
+		size_t length;
+	};
+	struct Key
+	{
+		const char* string;
+		size_t length;
+		bool operator==(const Key& key) const;
+	};
+	struct KeyHasher
+	{
+		size_t operator()(const Key& key) const;
+	};
+	// Copy a string in blocks & return the stable copy
+	const char* store(const char* string, size_t length);
+	const Entry& getEntry(StringID id) const;
+private:
+	mutable std::shared_mutex m_mutex;
+	HashMap<Key, StringID, KeyHasher> m_ids; // Keys point to stored strings
+	std::atomic<Entry*> m_pages[PageCount]; // Entries never move so that reverse lookup is lock free
+	std::atomic<uint32_t> m_count;
+	Vector<char*> m_blocks; // All allocations storing characters
+	char* m_block; // Current block where strings are stored
+	size_t m_blockOffset; // Offset in current block
+	size_t m_usedMemory;
+};
+
+// Get the global string table
+StringTable& getStringTable();
+
+};
+
+template <>
+struct std::hash<aka::StringID>
+{
+	size_t operator()(const aka::StringID& id) const
+	{
+		return static_cast<size_t>(id);
+	}
+};
@@ -1,12 +1,16 @@
 #pragma once
 
 #include <mutex>
+#include <atomic>
 #include <functional>
 
+#include <Aka/Core/Enum.h>
 #include <Aka/Core/Container/Vector.h>
 
 namespace aka {
 
+class WorkerPool;
+
 enum class JobStatus
 {
 	Waiting,
@@ -14,15 +18,88 @@ enum class JobStatus
 	Finished
 };
 
+// Priority of a job. Workers always pick the most urgent job available.
+enum class JobPriority : uint8_t
+{
+	Critical, // Jobs the current frame is waiting on.
+	Normal,
+	Background, // Jobs that can take several frames, such as asset processing.
+
+	First = Critical,
+	Last = Background,
+};
+
+// Counter tracking a set of jobs. Reach zero when all of them are finished.
+// Can be used as a fence to wait for a group of jobs with WorkerPool::wait.
+class JobCounter
+{
+public:
+	JobCounter();
+	JobCounter(const JobCounter&) = delete;
+	JobCounter& operator=(const JobCounter&) = delete;
+	~JobCounter();
+
+	// Get the number of jobs still running
+	uint32_t get() const;
+	// Check if all jobs tracked are finished
+	bool isFinished() const;
+private:
+	friend class WorkerPool;
+	std::atomic<uint32_t> m_count;
+};
+
+// Token shared by a group of jobs to cancel them cooperatively.
+// Jobs not started yet are skipped, running jobs can check Job::isCancelled to exit early.
+// Must outlive the jobs using it.
+class CancellationToken
+{
+public:
+	CancellationToken();
+	CancellationToken(const CancellationToken&) = delete;
+	CancellationToken& operator=(const CancellationToken&) = delete;
+	~CancellationToken();
+
+	// Request cancellation of all jobs using this token
+	void cancel();
+	// Reset the token so that it can be reused
+	void reset();
+	// Check if cancellation was requested
+	bool isCancelled() const;
+private:
+	std::atomic<bool> m_cancelled;
+};
+
 class Job
 {
 public:
+	// Maximum number of jobs that can depend on a single job.
+	static const uint32_t maxContinuationCount = 8;
+public:
+	Job();
+	Job(const Job&) = delete;
+	Job& operator=(const Job&) = delete;
 	virtual ~Job() {}
 	// Execute the job and setup running flag
 	void operator()() { execute(); }
+	// Set the token used to cancel this job. Must be called before the job is run.
+	void setCancellationToken(const CancellationToken* token);
+	// Check if the job was cancelled
+	bool isCancelled() const;
 protected:
 	// Execute the job
 	virtual void execute() = 0;
+private:
+	friend class WorkerPool;
+	const CancellationToken* m_token; // Token to check for cancellation, if any.
+	Job* m_parent; // Parent job waiting for this job to finish.
+	JobCounter* m_counter; // Counter to decrement when this job is finished.
+	std::atomic<uint32_t> m_unfinishedJobs; // This job and all its unfinished childrens.
+	std::atomic<uint32_t> m_pendingDependencies; // Dependencies not finished yet + submission.
+	std::atomic<uint32_t> m_continuationCount; // Number of jobs waiting on this one.
+	Job* m_continuations[maxContinuationCount]; // Jobs waiting on this one.
+	JobPriority m_priority; // Priority of the queue the job is pushed to.
+	bool m_io; // Job is blocking & must run on an I/O worker.
+	uint64_t m_queuedTime; // Time the job was queued, in microseconds.
 };
 
 class TrackedJob
@@ -44,15 +121,52 @@ private:
 	JobStatus m_status;
 };
 
+// Job executing a callable, stored inline when small enough to avoid any allocation.
 class LambdaJob : public Job
 {
 public:
-	LambdaJob(std::function<void(void)>&& lambda);
+	// Size of the inline storage for the callable.
+	static const size_t inlineSize = 64;
+	static const size_t inlineAlignment = 16;
+public:
+	template <typename Func>
+	LambdaJob(Func&& lambda);
+	~LambdaJob();
 protected:
 	void execute() override;
 private:
-	std::function<void(void)> m_job;
+	template <typename Func> static constexpr bool isInline();
+	using InvokeFunc = void(*)(void*);
+	using DestroyFunc = void(*)(void*);
+	alignas(inlineAlignment) uint8_t m_storage[inlineSize]; // Callable if inline, pointer to callable otherwise.
+	InvokeFunc m_invoke;
+	DestroyFunc m_destroy;
 };
 
+template <typename Func>
+inline constexpr bool LambdaJob::isInline()
+{
+	return sizeof(Func) <= inlineSize && alignof(Func) <= inlineAlignment && std::is_nothrow_move_constructible<Func>::value;
+}
+
+template <typename Func>
+inline LambdaJob::LambdaJob(Func&& lambda)
+{
+	using Callable = typename std::decay<Func>::type;
+	if constexpr (isInline<Callable>())
+	{
+		new (m_storage) Callable(std::forward<Func>(lambda));
+		m_invoke = [](void* storage) { (*static_cast<Callable*>(storage))(); };
+		m_destroy = [](void* storage) { static_cast<Callable*>(storage)->~Callable(); };
+	}
+	else
+	{
+		// Callable too big, store it on the heap.
+		Callable* callable = mem::akaNew<Callable>(AllocatorMemoryType::Object, AllocatorCategory::Global, std::forward<Func>(lambda));
+		*reinterpret_cast<Callable**>(m_storage) = callable;
+		m_invoke = [](void* storage) { (**static_cast<Callable**>(storage))(); };
+		m_destroy = [](void* storage) { mem::akaDelete(*static_cast<Callable**>(storage)); };
+	}
+}
 
-};
\ No newline at end of file
+};
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+namespace aka {
+
+class JobRecordCache;
+
+// Allocator for job records.
+// Jobs are allocated in fixed size records recycled through a per thread cache, so that submitting jobs does not hit the heap.
+// Records freed from another thread are sent back to their owner cache without locking.
+class JobAllocator
+{
+public:
+	// Size of a job record, header included.
+	static const size_t recordSize = 256;
+	// Alignment of a job record.
+	static const size_t recordAlignment = 16;
+	// Maximum size of a job fitting in a record. Bigger jobs fall back to the object allocator.
+	static const size_t maxJobSize = recordSize - recordAlignment;
+public:
+	// Allocate memory for a job
+	static void* allocate(size_t size);
+	// Deallocate memory of a job
+	static void deallocate(void* data);
+};
+
+};
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <atomic>
+#include <mutex>
+#include <stdint.h>
+
+#include <Aka/Core/Container/Vector.h>
+#include <Aka/Core/Container/MPMCQueue.h>
+
+namespace aka {
+
+class Job;
+
+// Bounded work stealing deque (Chase-Lev).
+// Only the owner thread can push & pop at the bottom, any thread can steal from the top.
+class JobQueue
+{
+public:
+	static const int64_t capacity = 4096;
+	static_assert((capacity & (capacity - 1)) == 0, "Capacity must be a power of 2.");
+public:
+	JobQueue();
+	JobQueue(const JobQueue&) = delete;
+	JobQueue& operator=(const JobQueue&) = delete;
+	~JobQueue();
+
+	// Push a job at the bottom of the queue. Owner thread only. Return false if full.
+	bool push(Job* job);
+	// Pop a job from the bottom of the queue. Owner thread only.
+	Job* pop();
+	// Steal a job from the top of the queue. Any thread.
+	Job* steal();
+	// Approximate number of jobs in the queue.
+	size_t size() const;
+	// Check if the queue is approximately empty.
+	bool empty() const;
+private:
+	// Padding to avoid false sharing between owner & thieves.
+	std::atomic<int64_t> m_top;
+	uint8_t m_paddingTop[64 - sizeof(std::atomic<int64_t>)];
+	std::atomic<int64_t> m_bottom;
+	uint8_t m_paddingBottom[64 - sizeof(std::atomic<int64_t>)];
+	std::atomic<Job*> m_jobs[capacity];
+};
+
+// Unbounded FIFO queue, for jobs submitted by threads without a deque.
+// Jobs go through a lock free queue & only fall back to a mutex protected overflow when it is full.
+// Order is only approximately FIFO once overflow is used.
+class SharedJobQueue
+{
+public:
+	SharedJobQueue();
+	SharedJobQueue(const SharedJobQueue&) = delete;
+	SharedJobQueue& operator=(const SharedJobQueue&) = delete;
+	~SharedJobQueue();
+
+	// Push a job at the end of the queue. Any thread.
+	void push(Job* job);
+	// Pop a job from the front of the queue. Any thread.
+	Job* pop();
+	// Approximate number of jobs in the queue.
+	size_t size() const;
+	// Check if the queue is approximately empty.
+	bool empty() const;
+private:
+	static const size_t capacity = 1024;
+	MPMCQueue<Job*, capacity> m_queue;
+	std::mutex m_mutex;
+	std::atomic<size_t> m_count; // Number of jobs in overflow
+	Vector<Job*> m_jobs; // Overflow ring buffer of jobs. Only grows.
+	size_t m_offset; // Offset of the first job in the ring buffer.
+};
+
+};
@@ -0,0 +1,160 @@
+#pragma once
+
+#include <atomic>
+
+#include <Aka/Core/Container/Vector.h>
+#include <Aka/Core/Worker/WorkerPool.h>
+#include <Aka/Memory/Pool.h>
+
+namespace aka {
+
+// Data parallel helpers running on a WorkerPool.
+// Work is split in chunks of grainSize elements that are picked by workers & by the calling thread, which takes part until everything is done.
+// A grainSize of zero let the helper choose one depending on the number of workers.
+// Reductions are computed per chunk & combined in chunk order, so the result does not depend on scheduling.
+// Each chunk accumulates into a local partial & stores it once, so that workers do not write to shared cache lines.
+
+// Run func(chunkIndex) for every chunk in [0, chunkCount)
+template <typename Func>
+void parallelForChunk(WorkerPool& pool, size_t chunkCount, Func&& func);
+
+// Run func(index) for every index in [begin, end)
+template <typename Func>
+void parallelFor(WorkerPool& pool, size_t begin, size_t end, Func&& func, size_t grainSize = 0);
+// Run func(element) for every element of the vector
+template <typename T, AllocatorCategory Category, typename Func>
+void parallelFor(WorkerPool& pool, Vector<T, Category>& vector, Func&& func, size_t grainSize = 0);
+// Run func(element) for every acquired element of the pool. Grain size is a number of pool blocks.
+template <typename T, size_t ChunkCountPerBlock, typename Func>
+void parallelFor(WorkerPool& pool, Pool<T, ChunkCountPerBlock>& elements, Func&& func, size_t grainSize = 0);
+
+// Accumulate func(partial, index) for every index in [begin, end) & combine partials with reduce(result, partial)
+template <typename R, typename Func, typename Reduce>
+R parallelReduce(WorkerPool& pool, size_t begin, size_t end, const R& identity, Func&& func, Reduce&& reduce, size_t grainSize = 0);
+// Accumulate func(partial, element) for every acquired element of the pool & combine partials with reduce(result, partial). Grain size is a number of pool blocks.
+template <typename R, typename T, size_t ChunkCountPerBlock, typename Func, typename Reduce>
+R parallelReduce(WorkerPool& pool, Pool<T, ChunkCountPerBlock>& elements, const R& identity, Func&& func, Reduce&& reduce, size_t grainSize = 0);
+
+// Get grain size for a given number of elements
+inline size_t getParallelGrainSize(const WorkerPool& pool, size_t count, size_t grainSize)
+{
+	if (grainSize > 0)
+		return grainSize;
+	// Some chunks per thread so that workers can balance the load.
+	const size_t chunkCount = (pool.count() + 1) * 4;
+	return max<size_t>((count + chunkCount - 1) / chunkCount, 1);
+}
+
+template <typename Func>
+void parallelForChunk(WorkerPool& pool, size_t chunkCount, Func&& func)
+{
+	if (chunkCount == 0)
+		return;
+	if (chunkCount == 1)
+	{
+		func(0);
+		return;
+	}
+	struct State {
+		std::atomic<size_t> next;
+		size_t chunkCount;
+		Func* func;
+	} state{ {0}, chunkCount, &func };
+	auto process = [](State& _state) {
+		size_t chunk;
+		while ((chunk = _state.next.fetch_add(1, std::memory_order_relaxed)) < _state.chunkCount)
+			(*_state.func)(chunk);
+	};
+	// Workers pull chunks from a shared index, so no more jobs than workers are needed.
+	const size_t jobCount = min<size_t>(pool.count(), chunkCount - 1);
+	JobCounter counter;
+	for (size_t iJob = 0; iJob < jobCount; iJob++)
+	{
+		State* statePtr = &state;
+		pool.run(pool.createJob<LambdaJob>([statePtr, process]() { process(*statePtr); }), &counter);
+	}
+	// Calling thread take part.
+	process(state);
+	pool.wait(counter);
+}
+
+template <typename Func>
+void parallelFor(WorkerPool& pool, size_t begin, size_t end, Func&& func, size_t grainSize)
+{
+	if (end <= begin)
+		return;
+	const size_t count = end - begin;
+	const size_t grain = getParallelGrainSize(pool, count, grainSize);
+	const size_t chunkCount = (count + grain - 1) / grain;
+	parallelForChunk(pool, chunkCount, [&](size_t chunk) {
+		const size_t chunkBegin = begin + chunk * grain;
+		const size_t chunkEnd = min<size_t>(chunkBegin + grain, end);
+		for (size_t index = chunkBegin; index < chunkEnd; index++)
+			func(index);
+	});
+}
+
+template <typename T, AllocatorCategory Category, typename Func>
+void parallelFor(WorkerPool& pool, Vector<T, Category>& vector, Func&& func, size_t grainSize)
+{
+	T* data = vector.data();
+	parallelFor(pool, 0, vector.size(), [&](size_t index) {
+		func(data[index]);
+	}, grainSize);
+}
+
+template <typename T, size_t ChunkCountPerBlock, typename Func>
+void parallelFor(WorkerPool& pool, Pool<T, ChunkCountPerBlock>& elements, Func&& func, size_t grainSize)
+{
+	const size_t blockCount = elements.getBlockCount();
+	const size_t grain = grainSize > 0 ? grainSize : 1;
+	const size_t chunkCount = (blockCount + grain - 1) / grain;
+	parallelForChunk(pool, chunkCount, [&](size_t chunk) {
+		elements.visit(chunk * grain, grain, func);
+	});
+}
+
+template <typename R, typename Func, typename Reduce>
+R parallelReduce(WorkerPool& pool, size_t begin, size_t end, const R& identity, Func&& func, Reduce&& reduce, size_t grainSize)
+{
+	if (end <= begin)
+		return identity;
+	const size_t count = end - begin;
+	const size_t grain = getParallelGrainSize(pool, count, grainSize);
+	const size_t chunkCount = (count + grain - 1) / grain;
+	Vector<R> partials(chunkCount, identity);
+	parallelForChunk(pool, chunkCount, [&](size_t chunk) {
+		const size_t chunkBegin = begin + chunk * grain;
+		const size_t chunkEnd = min<size_t>(chunkBegin + grain, end);
+		R partial = identity;
+		for (size_t index = chunkBegin; index < chunkEnd; index++)
+			func(partial, index);
+		partials[chunk] = std::move(partial);
+	});
+	R result = identity;
+	for (const R& partial : partials)
+		reduce(result, partial);
+	return result;
+}
+
+template <typename R, typename T, size_t ChunkCountPerBlock, typename Func, typename Reduce>
+R parallelReduce(WorkerPool& pool, Pool<T, ChunkCountPerBlock>& elements, const R& identity, Func&& func, Reduce&& reduce, size_t grainSize)
+{
+	const size_t blockCount = elements.getBlockCount();
+	const size_t grain = grainSize > 0 ? grainSize : 1;
+	const size_t chunkCount = (blockCount + grain - 1) / grain;
+	Vector<R> partials(chunkCount, identity);
+	parallelForChunk(pool, chunkCount, [&](size_t chunk) {
+		R partial = identity;
+		elements.visit(chunk * grain, grain, [&](T& element) {
+			func(partial, element);
+		});
+		partials[chunk] = std::move(partial);
+	});
+	R result = identity;
+	for (const R& partial : partials)
+		reduce(result, partial);
+	return result;
+}
+
+};
@@ -5,65 +5,200 @@
 #include <mutex>
 #include <thread>
 #include <list>
+#include <atomic>
 #include <functional>
 
+#include <Aka/OS/Time.h>
 #include <Aka/Core/Container/Vector.h>
+#include <Aka/Core/Worker/Job.h>
+#include <Aka/Core/Worker/JobQueue.h>
+#include <Aka/Core/Worker/JobAllocator.h>
 
 namespace aka {
 
-class Job;
+// Statistics of a job queue. Times are in microseconds.
+struct JobQueueStats
+{
+	size_t queuedJobs; // Jobs waiting in the queue.
+	size_t executedJobs; // Jobs picked from the queue since last reset.
+	uint64_t averageWaitTime; // Average time spent by jobs in the queue.
+	uint64_t maxWaitTime; // Max time spent by a job in the queue.
+};
 
+// Pool of worker threads executing a graph of jobs.
+// Each worker own a queue per priority & steal jobs from other workers when it runs out of jobs.
+// Blocking jobs (file reads...) run on a separate group of I/O workers which never take compute jobs, so they cannot stall the frame.
+// Jobs are owned by the pool once created & are destroyed once they and all their childs are finished.
+// Job memory comes from JobAllocator records, so submitting jobs does not allocate once records are warmed up.
 class WorkerPool
 {
 public:
 	WorkerPool();
-	WorkerPool(size_t size);
+	WorkerPool(size_t size, size_t ioSize = 1);
 	WorkerPool(const WorkerPool&) = delete;
 	WorkerPool& operator=(const WorkerPool&) = delete;
 	~WorkerPool();
 
 	// Start all the workers
 	void start();
-	// Signal all the workers to stop
+	// Signal all the workers to stop once queues are empty
 	void stop();
 	// Wait for all the workers to stop
 	void wait();
-	// Kill the workers
+	// Stop the workers without running queued jobs & wait for running jobs to finish.
 	void kill();
-	// Reset the queue
+	// Stop the workers once queues are drained & wait for them.
+	// If queues are not drained before timeout, remaining jobs are skipped. Return false in this case.
+	// Pool can be started again afterwards.
+	bool shutdown(Time timeout);
+	// Reset the queue. Jobs not started are finished without being executed.
 	void reset();
 	// Is the worker active
 	bool isActive() const;
 	// Queue size
 	size_t size() const;
+	// Number of worker threads
+	size_t count() const;
+	// Number of I/O worker threads
+	size_t countIO() const;
 
 	// Create a job from arguments & add job to worker.
 	template <typename T, typename ...Args>
 	void addJob(Args ...args);
 
+public: // Job graph
+	// Create a job from arguments without scheduling it. Pool take ownership.
+	template <typename T, typename ...Args>
+	T* createJob(Args ...args);
+	// Create a child job of parent. Parent will be finished once all its childs are finished.
+	// Must be called before parent is finished, usually from within parent execution.
+	// Child use the cancellation token of its parent.
+	template <typename T, typename ...Args>
+	T* createChildJob(Job* parent, Args ...args);
+	// Make job wait for dependency to be finished before running.
+	// Must be called before both jobs are run.
+	void addDependency(Job* job, Job* dependency);
+	// Run a job, it will be executed once all its dependencies are finished.
+	// Counter is incremented & will be decremented once job and its childs are finished.
+	void run(Job* job, JobCounter* counter = nullptr, JobPriority priority = JobPriority::Normal);
+	// Run a blocking job on the I/O workers. Fallback to background priority if there is no I/O worker.
+	void runIO(Job* job, JobCounter* counter = nullptr);
+	// Wait for the counter to reach the given value, executing other jobs meanwhile.
+	void wait(const JobCounter& counter, uint32_t value = 0);
+	// Wait for the counter to reach the given value or for the timeout, executing other jobs meanwhile.
+	// Return false if timeout was reached.
+	bool waitFor(const JobCounter& counter, Time timeout, uint32_t value = 0);
+
+public: // Statistics
+	// Get statistics of the compute queues of a priority
+	JobQueueStats getStats(JobPriority priority) const;
+	// Get statistics of the I/O queue
+	JobQueueStats getIOStats() const;
+	// Reset executed jobs count & wait times
+	void resetStats();
+
 private:
-	// Add a job to a worker. Take ownership.
+	// Add a job to a queue. Take ownership.
 	void add(Job* job);
+	// Execute a job if not cancelled & finish it.
+	void execute(Job* job);
+	// Finish a job, destroy it & schedule its continuations.
+	void finish(Job* job);
+	// Destroy a job & give its record back.
+	static void destroy(Job* job);
+	// Decrement pending dependencies of a job & schedule it if ready.
+	void release(Job* job);
+	// Find a job from own queue, shared queue or steal it from another worker.
+	Job* find(uint32_t workerIndex);
+	// Find a job from the I/O queue.
+	Job* findIO();
+	// Wait for jobs to be added.
+	void sleep();
+	// Wait for I/O jobs to be added.
+	void sleepIO();
+	// Signal that a worker exited its loop.
+	void exit();
+	// Get the deque of a worker for a priority.
+	JobQueue& getQueue(uint32_t workerIndex, JobPriority priority);
 
 private:
 	// Loop and execute a thread
-	void loop();
+	void loop(uint32_t workerIndex);
+	// Loop and execute an I/O thread
+	void loopIO();
 
 private:
-	mutable std::mutex m_mutex;
+	static const uint32_t invalidWorkerIndex = ~0U;
+	static const uint32_t priorityCount = EnumCount<JobPriority>();
+
+	// Counters updated when jobs are queued & picked.
+	struct Stats
+	{
+		Stats();
+		// Job was added to the queue
+		void push(Job* job);
+		// Job was picked from the queue
+		void pop(Job* job);
+		// Get a snapshot of the stats
+		JobQueueStats get() const;
+		// Reset executed count & wait times
+		void reset();
+
+		std::atomic<size_t> queuedJobs;
+		std::atomic<size_t> executedJobs;
+		std::atomic<uint64_t> totalWaitTime;
+		std::atomic<uint64_t> maxWaitTime;
+	};
+
+	mutable std::mutex m_mutex; // Mutex for sleeping workers
 	std::condition_variable m_condition;
-	std::list<Job*> m_jobs;
+	std::atomic<uint32_t> m_sleepingWorkers;
+	std::atomic<size_t> m_pendingJobs; // Compute jobs queued but not picked yet.
+	std::condition_variable m_exitCondition;
+	std::atomic<uint32_t> m_activeWorkers; // Workers & I/O workers not exited yet.
+
+	SharedJobQueue m_sharedQueues[priorityCount]; // Jobs submitted from threads outside of the pool.
+	JobQueue* m_queues; // One queue per worker & priority.
 	Vector<std::thread> m_workers;
-	bool m_running;
+	Stats m_stats[priorityCount];
+
+	mutable std::mutex m_ioMutex; // Mutex for sleeping I/O workers
+	std::condition_variable m_ioCondition;
+	std::atomic<uint32_t> m_sleepingIOWorkers;
+	SharedJobQueue m_ioQueue;
+	Vector<std::thread> m_ioWorkers;
+	Stats m_ioStats;
+
+	std::atomic<bool> m_running;
+	std::atomic<bool> m_aborting; // Skip queued jobs instead of executing them.
 };
 
 
 template<typename T, typename ...Args>
 inline void WorkerPool::addJob(Args ...args)
+{
+	run(createJob<T>(std::forward<Args>(args)...));
+}
+
+template<typename T, typename ...Args>
+inline T* WorkerPool::createJob(Args ...args)
 {
 	static_assert(std::is_base_of<Job, T>::value, "Trying to add object that is not a job.");
-	Job* job = mem::akaNew<T>(AllocatorMemoryType::Object, AllocatorCategory::Global, std::forward<Args>(args)...);
-	add(job);
+	static_assert(alignof(T) <= JobAllocator::recordAlignment, "Job alignment is bigger than job record alignment.");
+	void* data = JobAllocator::allocate(sizeof(T));
+	return new (data) T(std::forward<Args>(args)...);
 }
 
-};
\ No newline at end of file
+template<typename T, typename ...Args>
+inline T* WorkerPool::createChildJob(Job* parent, Args ...args)
+{
+	AKA_ASSERT(parent != nullptr, "Invalid parent");
+	AKA_ASSERT(parent->m_unfinishedJobs.load(std::memory_order_relaxed) > 0, "Parent already finished");
+	T* job = createJob<T>(std::forward<Args>(args)...);
+	job->m_parent = parent;
+	job->m_token = parent->m_token;
+	parent->m_unfinishedJobs.fetch_add(1, std::memory_order_relaxed);
+	return job;
+}
+
+};
@@ -2,6 +2,7 @@
 
 #include <Aka/Core/Config.h>
 #include <Aka/Memory/AllocatorTracker.hpp>
+#include <Aka/Memory/AllocatorBudget.hpp>
 #include <Aka/Memory/AllocatorTypes.hpp>
 
 #include <map>
@@ -75,6 +76,8 @@ protected:
 protected:
 
 	const char* getName() const;
+	// Get first memory block allocated
+	MemoryBlock* getFirstMemoryBlock();
 	// Get last memory block allocated
 	MemoryBlock* getMemoryBlock();
 	// Get parent allocator
@@ -83,6 +86,12 @@ protected:
 	MemoryBlock* requestNewMemoryBlock();
 	// Release all memory block & call parent allocator to free memory.
 	void releaseAllMemoryBlocks();
+	// Stop tracking allocations in [begin, end) that were freed in bulk without deallocate.
+	void untrackRange(const void* begin, const void* end);
+	// Charge an allocation to the budget of the category. Only allocators without parent are charged, as they request memory from the system.
+	void acquireBudget(size_t size);
+	// Give back a deallocation to the budget of the category.
+	void releaseBudget(size_t size);
 private:
 	char m_name[32];
 	AllocatorMemoryType m_type;
@@ -103,11 +112,15 @@ constexpr size_t getMetadataSize()
 template <typename Type, typename Metadata>
 Type* Allocator::allocate(size_t count, AllocatorFlags flags)
 {
+	// Budgets rely on the tracker for deallocation sizes, see AllocatorBudget.hpp.
 #if defined(AKA_TRACK_MEMORY_ALLOCATIONS)
 	AllocatorTracker& tracker = getAllocatorTracker();
+	acquireBudget(count * sizeof(Type));
 #endif
 	void* data = allocate_internal(count * sizeof(Type) + getMetadataSize<Metadata>(), flags);
 #if defined(AKA_TRACK_MEMORY_ALLOCATIONS)
+	if (data == nullptr)
+		releaseBudget(count * sizeof(Type));
 	tracker.allocate<Type>(data, count, m_type, m_category);
 #endif
 	return static_cast<Type*>(static_cast<void*>(asByte(data) + getMetadataSize<Metadata>()));
@@ -120,7 +133,7 @@ void Allocator::deallocate(void* elements)
 		return;
 #if defined(AKA_TRACK_MEMORY_ALLOCATIONS)
 	AllocatorTracker& tracker = getAllocatorTracker();
-	tracker.deallocate(static_cast<void*>(asByte(elements) - getMetadataSize<Metadata>()), m_type, m_category);
+	releaseBudget(tracker.deallocate(static_cast<void*>(asByte(elements) - getMetadataSize<Metadata>()), m_type, m_category));
 #endif
 	deallocate_internal(static_cast<void*>(asByte(elements) - getMetadataSize<Metadata>()));
 }
@@ -130,10 +143,22 @@ Type* Allocator::reallocate(void* elements, size_t count, AllocatorFlags flags)
 {
 	// TODO: handle metadata alignment
 	void* elementMetadata = elements ? static_cast<void*>(asByte(elements) - getMetadataSize<Metadata>()) : nullptr;
-	void* data = reallocate_internal(elementMetadata, count * sizeof(Type) + getMetadataSize<Metadata>(), flags);
 #if defined(AKA_TRACK_MEMORY_ALLOCATIONS)
 	AllocatorTracker& tracker = getAllocatorTracker();
 	void* pOriginal = static_cast<void*>(asByte(elements) - getMetadataSize<Metadata>());
+	// Only charge growth to the budget.
+	const size_t oldSize = tracker.getAllocationSize(elementMetadata, m_type, m_category);
+	const size_t newSize = count * sizeof(Type);
+	if (newSize > oldSize)
+		acquireBudget(newSize - oldSize);
+#endif
+	void* data = reallocate_internal(elementMetadata, count * sizeof(Type) + getMetadataSize<Metadata>(), flags);
+#if defined(AKA_TRACK_MEMORY_ALLOCATIONS)
+	// On failure, original allocation is left untouched.
+	if (data == nullptr)
+		releaseBudget(newSize > oldSize ? newSize - oldSize : 0);
+	else if (oldSize > newSize)
+		releaseBudget(oldSize - newSize);
 	tracker.reallocate<Type>(pOriginal, data, count, m_type, m_category);
 #endif
 	return static_cast<Type*>(static_cast<void*>(asByte(data) + getMetadataSize<Metadata>()));
@@ -144,10 +169,13 @@ Type* Allocator::alignedAllocate(size_t count, size_t alignment, AllocatorFlags
 {
 #if defined(AKA_TRACK_MEMORY_ALLOCATIONS)
 	AllocatorTracker& tracker = getAllocatorTracker();
+	acquireBudget(count * sizeof(Type));
 #endif
 	// TODO: metadata size must be aligned aswell...
 	void* data = alignedAllocate_internal(count * sizeof(Type) + getMetadataSize<Metadata>(), alignment, flags);
 #if defined(AKA_TRACK_MEMORY_ALLOCATIONS)
+	if (data == nullptr)
+		releaseBudget(count * sizeof(Type));
 	tracker.alignedAllocate<Type>(data, count, alignment, m_type, m_category);
 #endif
 	return static_cast<Type*>(static_cast<void*>(asByte(data) + getMetadataSize<Metadata>()));
@@ -160,7 +188,7 @@ void Allocator::alignedDeallocate(void* elements)
 		return;
 #if defined(AKA_TRACK_MEMORY_ALLOCATIONS)
 	AllocatorTracker& tracker = getAllocatorTracker();
-	tracker.deallocate(static_cast<void*>(asByte(elements) - getMetadataSize<Metadata>()), m_type, m_category);
+	releaseBudget(tracker.deallocate(static_cast<void*>(asByte(elements) - getMetadataSize<Metadata>()), m_type, m_category));
 #endif
 	alignedDeallocate_internal(static_cast<void*>(asByte(elements) - getMetadataSize<Metadata>()));
 }
@@ -170,10 +198,22 @@ inline Type* Allocator::alignedReallocate(void* elements, size_t count, size_t a
 {
 	// TODO: handle metadata alignment
 	void* elementMetadata = elements ? static_cast<void*>(asByte(elements) - getMetadataSize<Metadata>()) : nullptr;
-	void* data = alignedReallocate_internal(elementMetadata, count * sizeof(Type) + getMetadataSize<Metadata>(), alignment, flags);
 #if defined(AKA_TRACK_MEMORY_ALLOCATIONS)
 	AllocatorTracker& tracker = getAllocatorTracker();
 	void* pOriginal = static_cast<void*>(asByte(elements) - getMetadataSize<Metadata>());
+	// Only charge growth to the budget.
+	const size_t oldSize = tracker.getAllocationSize(elementMetadata, m_type, m_category);
+	const size_t newSize = count * sizeof(Type);
+	if (newSize > oldSize)
+		acquireBudget(newSize - oldSize);
+#endif
+	void* data = alignedReallocate_internal(elementMetadata, count * sizeof(Type) + getMetadataSize<Metadata>(), alignment, flags);
+#if defined(AKA_TRACK_MEMORY_ALLOCATIONS)
+	// On failure, original allocation is left untouched.
+	if (data == nullptr)
+		releaseBudget(newSize > oldSize ? newSize - oldSize : 0);
+	else if (oldSize > newSize)
+		releaseBudget(oldSize - newSize);
 	tracker.alignedReallocate<Type>(pOriginal, data, count, alignment, m_type, m_category);
 #endif
 	return static_cast<Type*>(static_cast<void*>(asByte(data) + getMetadataSize<Metadata>()));
@@ -1,16 +1,49 @@
 #pragma once
 
+#include <cstddef>
+
 #include <Aka/Core/Config.h>
 #include <Aka/Memory/Allocator.h>
 
 namespace aka {
 
+// Allocator bumping a pointer in memory blocks from the parent allocator.
+// Allocations are never freed individually, everything is freed at once with reset or by rewinding to a marker.
+// It is not thread safe, use one instance per thread.
 class LinearAllocator : public Allocator
 {
+public:
+	// Position in the arena
+	struct Marker
+	{
+		MemoryBlock* block;
+		size_t offset;
+	};
+	// Rewind the allocator to its position at construction when going out of scope.
+	class Scope
+	{
+	public:
+		Scope(LinearAllocator& allocator);
+		Scope(const Scope&) = delete;
+		Scope& operator=(const Scope&) = delete;
+		~Scope();
+	private:
+		LinearAllocator& m_allocator;
+		Marker m_marker;
+	};
 public:
 	LinearAllocator(const char* name, AllocatorMemoryType memoryType, AllocatorCategory category, Allocator* parent, size_t blockSize);
 	virtual ~LinearAllocator();
 
+	// Get the current position in the arena
+	Marker getMarker() const;
+	// Free everything allocated after the marker. Memory blocks are kept for reuse.
+	void rewind(Marker marker);
+	// Free everything. Memory blocks are kept for reuse.
+	void reset();
+	// Get the number of bytes used since last reset, including alignment & unused block tails.
+	size_t used() const;
+protected:
 	void* allocate_internal(size_t size, AllocatorFlags flags = AllocatorFlags::None) override;
 	void* alignedAllocate_internal(size_t size, size_t alignement, AllocatorFlags flags = AllocatorFlags::None)  override;
 	void deallocate_internal(void* elements) override;
@@ -18,7 +51,9 @@ public:
 	void* reallocate_internal(void* elements, size_t size, AllocatorFlags flags = AllocatorFlags::None) override;
 	void* alignedReallocate_internal(void* elements, size_t size, size_t alignment, AllocatorFlags flags = AllocatorFlags::None) override;
 private:
-	size_t m_offset;
+	MemoryBlock* m_block; // Current block. Next blocks are free.
+	size_t m_offset; // Offset in current block.
+	void* m_last; // Last allocation, which can grow in place.
 };
 
 };
@@ -1,25 +1,39 @@
 #pragma once
 
+#include <cstddef>
+
 #include <Aka/Core/Config.h>
 #include <Aka/Memory/Allocator.h>
 
 namespace aka {
 
-/*class PoolAllocator final : public Allocator
+// Allocator of fixed size objects, backed by memory blocks from the parent allocator.
+// Allocation & deallocation are O(1) through a free list stored inside free objects.
+class PoolAllocator final : public Allocator
 {
 public:
-	PoolAllocator(void* mem, size_t size, size_t objectSize, size_t objectAlignment);
+	PoolAllocator(const char* name, AllocatorMemoryType memoryType, AllocatorCategory category, Allocator* parent, size_t blockSize, size_t objectSize, size_t objectAlignment = alignof(std::max_align_t));
 	~PoolAllocator();
 
-	void* allocate(size_t size, size_t alignment = 0) override;
-	void deallocate(void* address, size_t size) override;
-	void reset() override;
-	bool contiguous() const override;
+	// Release all objects at once. Memory blocks are kept for reuse.
+	void reset();
+	// Get number of objects allocated
+	size_t count() const;
+protected:
+	void* allocate_internal(size_t size, AllocatorFlags flags = AllocatorFlags::None) override;
+	void* alignedAllocate_internal(size_t size, size_t alignement, AllocatorFlags flags = AllocatorFlags::None) override;
+	void deallocate_internal(void* elements) override;
+	void alignedDeallocate_internal(void* elements) override;
+	void* reallocate_internal(void* elements, size_t size, AllocatorFlags flags = AllocatorFlags::None) override;
+	void* alignedReallocate_internal(void* elements, size_t size, size_t alignment, AllocatorFlags flags = AllocatorFlags::None) override;
+private:
+	// Add all objects of a block to the free list
+	void addToFreeList(MemoryBlock* block);
 private:
+	size_t m_objectSize; // Size of an object, including padding for alignment
 	size_t m_objectAlignment;
-	size_t m_objectCount;
-	size_t m_objectSize;
+	size_t m_objectCount; // Objects currently allocated
 	void** m_freeList;
-};*/
+};
 
 };
@@ -1,23 +1,42 @@
 #pragma once
 
+#include <cstddef>
+
 #include <Aka/Core/Config.h>
 #include <Aka/Memory/Allocator.h>
 
 namespace aka {
 
-class RingAllocator : public Allocator
+// Allocator bumping a pointer in a single memory block from the parent allocator, wrapping around at the end.
+// Allocations are not freed individually but in order, by releasing everything allocated before a marker.
+// Typically used for frames in flight: get a marker at the end of a frame & release it once the frame is done on the GPU.
+class RingAllocator final : public Allocator
 {
 public:
-	RingAllocator(MemoryBlock& block);
+	// Position in the ring
+	using Marker = uint64_t;
+public:
+	RingAllocator(const char* name, AllocatorMemoryType memoryType, AllocatorCategory category, Allocator* parent, size_t blockSize);
+	~RingAllocator();
 
+	// Get the current head of the ring
+	Marker getMarker() const;
+	// Release every allocation made before the marker.
+	void release(Marker marker);
+	// Release everything.
+	void reset();
+	// Get the number of bytes in use, including wasted bytes at wrap.
+	size_t used() const;
+protected:
 	void* allocate_internal(size_t size, AllocatorFlags flags = AllocatorFlags::None) override;
-	void* alignedAllocate_internal(size_t size, size_t alignement, AllocatorFlags flags = AllocatorFlags::None)  override;
+	void* alignedAllocate_internal(size_t size, size_t alignement, AllocatorFlags flags = AllocatorFlags::None) override;
 	void deallocate_internal(void* elements) override;
 	void alignedDeallocate_internal(void* elements) override;
 	void* reallocate_internal(void* elements, size_t size, AllocatorFlags flags = AllocatorFlags::None) override;
 	void* alignedReallocate_internal(void* elements, size_t size, size_t alignment, AllocatorFlags flags = AllocatorFlags::None) override;
 private:
-	size_t m_offset;
+	uint64_t m_head; // Total bytes allocated since creation.
+	uint64_t m_tail; // Total bytes released since creation.
 };
 
 };
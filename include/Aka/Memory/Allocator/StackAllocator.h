@@ -1,53 +1,51 @@
 #pragma once
 
-#include <Aka/Core/Debug.h>
+#include <cstddef>
+
+#include <Aka/Core/Config.h>
 #include <Aka/Memory/Allocator.h>
 
 namespace aka {
 
-/*class StackAllocator final : public Allocator
+// Allocator bumping a pointer in memory blocks from the parent allocator.
+// Allocations must be deallocated in reverse order, or all at once by rewinding to a marker.
+class StackAllocator final : public Allocator
 {
 public:
-	StackAllocator(void* mem, size_t size) :
-		Allocator(mem, size),
-		m_current(mem)
-	{
-	}
-	~StackAllocator()
-	{
-	}
-	void* allocate(size_t size, size_t alignement, size_t offset) override
-	{
-		uintptr_t current = (uintptr_t)m_mem + m_used;
-		size_t headerSize = sizeof(uint8_t);
-		size_t adjustment = Allocator::alignAdjustment(current + headerSize, alignement);
-		if (m_used + headerSize + adjustment + size > m_size)
-			return nullptr; // Not enough space in allocator
-		uintptr_t aligned = current + headerSize + adjustment;
-		m_used += size + headerSize + adjustment;
-		uint8_t* header = reinterpret_cast<uint8_t*>(aligned - headerSize);
-		*header = (uint8_t)adjustment;
-		m_current = (void*)aligned;
-		return (void*)aligned;
-	}
-	void deallocate(void* address, size_t size) override
-	{
-		AKA_ASSERT(address > m_mem && (uintptr_t)address < (uintptr_t)m_mem + m_size, "Invalid range");
-		//AKA_ASSERT(address + size - mem, "Invalid deallocation for stack.");
-		// TODO check we are deallocating the whole top of stack with size.
-		uint8_t* header = reinterpret_cast<uint8_t*>(address - sizeof(uint8_t));
-		*header = (uint8_t)adjustment;
-	}
-	void reset() override
+	// Position in the stack
+	struct Marker
 	{
-		m_used = 0;
-	}
-	bool contiguous() const override
+		MemoryBlock* block;
+		size_t offset;
+	};
+public:
+	StackAllocator(const char* name, AllocatorMemoryType memoryType, AllocatorCategory category, Allocator* parent, size_t blockSize);
+	~StackAllocator();
+
+	// Get the current top of the stack
+	Marker getMarker() const;
+	// Free everything allocated after the marker. Memory blocks are kept for reuse.
+	void rewind(Marker marker);
+	// Free everything. Memory blocks are kept for reuse.
+	void reset();
+protected:
+	void* allocate_internal(size_t size, AllocatorFlags flags = AllocatorFlags::None) override;
+	void* alignedAllocate_internal(size_t size, size_t alignement, AllocatorFlags flags = AllocatorFlags::None) override;
+	void deallocate_internal(void* elements) override;
+	void alignedDeallocate_internal(void* elements) override;
+	void* reallocate_internal(void* elements, size_t size, AllocatorFlags flags = AllocatorFlags::None) override;
+	void* alignedReallocate_internal(void* elements, size_t size, size_t alignment, AllocatorFlags flags = AllocatorFlags::None) override;
+private:
+	// Header stored before each allocation to pop it.
+	struct Header
 	{
-		return true;
-	}
+		Marker previous; // Top of the stack before this allocation.
+		size_t size; // Size of the allocation.
+	};
+	Header* getHeader(void* elements);
 private:
-	void* m_current;
-};*/
+	MemoryBlock* m_block; // Current block. Next blocks are free.
+	size_t m_offset; // Offset in current block.
+};
 
 };
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <atomic>
+#include <functional>
+
+#include <Aka/Memory/AllocatorTypes.hpp>
+#include <Aka/Memory/AllocatorTracker.hpp>
+#include <Aka/Core/Enum.h>
+
+// Allocators release budgets with the sizes recorded by the tracker, so budgets are only charged when allocations are tracked.
+#if !defined(AKA_TRACK_MEMORY_ALLOCATIONS)
+#error "Allocator budgets require AKA_TRACK_MEMORY_ALLOCATIONS"
+#endif
+
+namespace aka {
+
+// What to do when an allocation would exceed the hard limit of a budget.
+enum class AllocatorBudgetPolicy : uint8_t
+{
+	Assert, // Assert & let the allocation through.
+	Fail, // Throw std::bad_alloc.
+	Evict, // Ask the category to free memory, then fail if it is still over budget.
+};
+
+// Called when a category goes above its soft limit.
+using AllocatorSoftLimitCallback = std::function<void(AllocatorCategory category, size_t used, size_t softLimit)>;
+// Called to free memory of a category, for example by unloading cached assets. Return the number of bytes freed.
+using AllocatorEvictCallback = std::function<size_t(AllocatorCategory category, size_t requested)>;
+
+// Memory budget for an allocator category. Zero limits are ignored.
+struct AllocatorBudget
+{
+	size_t softLimit = 0;
+	size_t hardLimit = 0;
+	AllocatorBudgetPolicy policy = AllocatorBudgetPolicy::Assert;
+	AllocatorSoftLimitCallback onSoftLimit;
+	AllocatorEvictCallback onEvict;
+};
+
+// Budgets of all categories, enforced by allocators requesting memory from the system.
+// Usage is lock free. Budgets should be set at initialization, before other threads allocate.
+class AllocatorBudgets
+{
+public:
+	AllocatorBudgets();
+
+	// Set the budget of a category
+	void set(AllocatorCategory category, const AllocatorBudget& budget);
+	// Get the budget of a category
+	const AllocatorBudget& get(AllocatorCategory category) const;
+	// Get the memory used by a category
+	size_t getUsedMemory(AllocatorCategory category) const;
+
+	// Charge an allocation to a category. Return false if it must fail.
+	bool acquire(AllocatorCategory category, size_t size);
+	// Give back memory of a deallocation to a category.
+	void release(AllocatorCategory category, size_t size);
+private:
+	AllocatorBudget m_budgets[EnumCount<AllocatorCategory>()];
+	std::atomic<size_t> m_used[EnumCount<AllocatorCategory>()];
+};
+
+AllocatorBudgets& getAllocatorBudgets();
+
+};
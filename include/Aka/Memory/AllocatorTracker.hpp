@@ -3,9 +3,13 @@
 #include <utility>
 #include <map>
 #include <typeinfo>
+#include <atomic>
+#include <mutex>
+#include <vector>
 
 #include <Aka/Memory/AllocatorTypes.hpp>
 #include <Aka/Core/Enum.h>
+#include <Aka/OS/CallStack.h>
 
 namespace aka {
 
@@ -20,14 +24,40 @@ struct AllocationTrackingData
 	size_t alignment = 0;
 	size_t elementSize = 0;
 	size_t count = 0;
+	uint64_t callStack = 0; // Hash of the call stack of the allocation, zero if not captured.
 
 	template <typename T> static AllocationTrackingData create(size_t count, size_t alignment = 0);
 };
 
-struct AllocatorTrackingData 
+// Live statistics of allocations for an allocator type & category.
+struct AllocatorStats
 {
+	static constexpr size_t HistogramBucketCount = 32;
+
+	size_t liveBytes = 0; // Bytes currently allocated.
+	size_t peakBytes = 0; // Highest value of live bytes since last peak reset.
+	size_t allocatedBytes = 0; // Bytes allocated since start.
+	size_t deallocatedBytes = 0; // Bytes deallocated since start.
+	size_t allocationCount = 0; // Allocations since start.
+	size_t deallocationCount = 0; // Deallocations since start.
+	size_t histogram[HistogramBucketCount] = {}; // Allocations since start, bucket i counting sizes in [2^i, 2^(i+1)).
+
+	// Get number of allocations still alive
+	size_t getLiveAllocationCount() const { return allocationCount - deallocationCount; }
+	// Get histogram bucket of an allocation size
+	static size_t getHistogramBucket(size_t size);
+	// Accumulate stats of another type or category
+	AllocatorStats& operator+=(const AllocatorStats& stats);
+};
+
+struct AllocatorSnapshot;
+
+// Track all allocations of allocators & gather statistics on them.
+// It is thread safe. Statistics are lock free & allocation records are sharded by address, each shard with its own lock.
+struct AllocatorTracker
+{
+public:
 	// custom allocator based on malloc to store allocations without tracking its own allocations.
-private:
 	template <class T>
 	struct malloc_allocator {
 		typedef size_t size_type;
@@ -55,13 +85,13 @@ private:
 			pointer temp = (pointer)malloc(s * sizeof(T));
 			if (temp == NULL)
 				throw std::bad_alloc();
-			m_used += s;
+			getUsedMemoryCounter().fetch_add(s * sizeof(T), std::memory_order_relaxed);
 			return temp;
 		}
 
 		void deallocate(pointer p, size_type s) {
 			free(p);
-			m_used -= s;
+			getUsedMemoryCounter().fetch_sub(s * sizeof(T), std::memory_order_relaxed);
 		}
 
 		size_type max_size() const throw() {
@@ -75,57 +105,103 @@ private:
 		void destroy(pointer p) {
 			p->~T();
 		}
-		size_t getUsedMemory() const { return m_used; }
-	private:
-		size_t m_used = 0;
-	};
-public:
-	struct TypeAllocationInfo
-	{
-		size_t count = 0;
-		size_t elementSize = 0;
-		size_t uniqueAllocation = 0;
+		template <class U> bool operator==(const malloc_allocator<U>&) const { return true; }
+		template <class U> bool operator!=(const malloc_allocator<U>&) const { return false; }
 	};
+	using CallStackMap = std::map<uint64_t, CallStack, std::less<uint64_t>, malloc_allocator<std::pair<const uint64_t, CallStack>>>;
 private:
 	using AllocationMap = std::map<const void*, AllocationTrackingData, std::less<const void*>, malloc_allocator<std::pair<const void* const, AllocationTrackingData>>>;
-	using TypeAllocationMap = std::map<const std::type_info*, TypeAllocationInfo, std::less<const std::type_info*>, malloc_allocator<std::pair<const std::type_info* const, TypeAllocationInfo>>>;
-public:
-	size_t m_allocation = 0;
-	size_t m_deallocation = 0;
-	size_t m_memoryAllocated = 0;
-	size_t m_memoryDeallocated = 0;
-	AllocationMap m_allocations;
-	TypeAllocationMap m_typeAllocations;
-
-	const AllocationMap& getAllocationMap() const { return m_allocations; }
-	const TypeAllocationMap& getTypeAllocationMap() const { return m_typeAllocations; }
-
-	size_t getUsedMemory() const {
-		return m_allocations.get_allocator().getUsedMemory() + sizeof(AllocatorTrackingData);
-	}
-};
-
-struct AllocatorTracker
-{
 public:
 	AllocatorTracker();
 	~AllocatorTracker();
 
 	template <typename T> void allocate(const void* const pointer, size_t count, AllocatorMemoryType type, AllocatorCategory category);
 	template <typename T> void alignedAllocate(const void* const pointer, size_t count, size_t alignment, AllocatorMemoryType type, AllocatorCategory category);
-	template <typename T> void reallocate(const void* const pOriginal, const void* const pNew, size_t count, AllocatorMemoryType type, AllocatorCategory category);
-	template <typename T> void alignedReallocate(const void* const pOriginal, const void* const pNew, size_t count, size_t alignment, AllocatorMemoryType type, AllocatorCategory category);
+	template <typename T> size_t reallocate(const void* const pOriginal, const void* const pNew, size_t count, AllocatorMemoryType type, AllocatorCategory category);
+	template <typename T> size_t alignedReallocate(const void* const pOriginal, const void* const pNew, size_t count, size_t alignment, AllocatorMemoryType type, AllocatorCategory category);
 	void allocate(const void* const pointer, AllocatorMemoryType type, AllocatorCategory category, const AllocationTrackingData& data);
-	void deallocate(const void* const pointer, AllocatorMemoryType type, AllocatorCategory category);
-	void reallocate(const void* const pOriginal, const void* const pNew, AllocatorMemoryType type, AllocatorCategory category, const AllocationTrackingData& data);
-
-	const AllocatorTrackingData& get(AllocatorMemoryType _type, AllocatorCategory _category) { return m_data[EnumToIndex(_type)][EnumToIndex(_category)]; }
-
+	// Stop tracking an allocation & return its size in bytes.
+	size_t deallocate(const void* const pointer, AllocatorMemoryType type, AllocatorCategory category);
+	// Deallocate all allocations in [begin, end), for allocators freeing memory in bulk.
+	void deallocateRange(const void* const begin, const void* const end, AllocatorMemoryType type, AllocatorCategory category);
+	// Track a reallocation & return size in bytes of the original allocation.
+	size_t reallocate(const void* const pOriginal, const void* const pNew, AllocatorMemoryType type, AllocatorCategory category, const AllocationTrackingData& data);
+
+	// Get size in bytes of a tracked allocation, zero if not tracked.
+	size_t getAllocationSize(const void* const pointer, AllocatorMemoryType type, AllocatorCategory category) const;
+
+	// Get live statistics of a type & category
+	AllocatorStats getStats(AllocatorMemoryType _type, AllocatorCategory _category) const;
+	// Get live statistics of a type, for all categories
+	AllocatorStats getStats(AllocatorMemoryType _type) const;
+	// Get live statistics of a category, for all types
+	AllocatorStats getStats(AllocatorCategory _category) const;
+	// Get live statistics of all allocations
+	AllocatorStats getStats() const;
+	// Reset peak bytes to live bytes, to measure peak over a period such as a frame.
+	void resetPeak();
+
+	// Capture call stack of one allocation out of rate on each thread. Zero disable capture, which is the default.
+	void setCallStackSampling(uint32_t rate);
+	// Take a snapshot of live allocations, grouped by type, category, element type & call stack.
+	AllocatorSnapshot takeSnapshot() const;
+	// Export remaining allocations to a file when tracker is destroyed at exit. Empty path disable it.
+	void setLeakReportPath(const char* path);
+
+	// Get memory used by the tracker itself
 	size_t getUsedMemory() const;
-	size_t getUsedMemory(AllocatorMemoryType _type) const;
-	size_t getUsedMemory(AllocatorMemoryType _type, AllocatorCategory _category) const;
 private:
-	AllocatorTrackingData m_data[EnumCount<AllocatorMemoryType>()][EnumCount<AllocatorCategory>()];
+	static std::atomic<size_t>& getUsedMemoryCounter();
+	// Remove an allocation from a locked shard & update statistics.
+	size_t erase(AllocationMap& allocations, AllocationMap::iterator it, AllocatorMemoryType type, AllocatorCategory category);
+private:
+	static constexpr size_t ShardCount = 16;
+	struct Shard
+	{
+		std::mutex mutex;
+		AllocationMap allocations[EnumCount<AllocatorMemoryType>()][EnumCount<AllocatorCategory>()];
+	};
+	struct Counters
+	{
+		std::atomic<size_t> liveBytes = 0;
+		std::atomic<size_t> peakBytes = 0;
+		std::atomic<size_t> allocatedBytes = 0;
+		std::atomic<size_t> deallocatedBytes = 0;
+		std::atomic<size_t> allocationCount = 0;
+		std::atomic<size_t> deallocationCount = 0;
+		std::atomic<size_t> histogram[AllocatorStats::HistogramBucketCount] = {};
+	};
+	Shard& getShard(const void* pointer) const;
+	// Capture call stack if sampled & return its hash.
+	uint64_t captureCallStack();
+	mutable Shard m_shards[ShardCount];
+	Counters m_counters[EnumCount<AllocatorMemoryType>()][EnumCount<AllocatorCategory>()];
+	std::atomic<uint32_t> m_callStackSampling;
+	mutable std::mutex m_callStackMutex;
+	CallStackMap m_callStacks; // Deduplicated call stacks
+	char m_leakReportPath[256];
+};
+
+// Live allocations at a given time.
+// Snapshots of different frames can be diffed to find what was allocated in between.
+struct AllocatorSnapshot
+{
+	struct Entry
+	{
+		AllocatorMemoryType type;
+		AllocatorCategory category;
+		const std::type_info* info;
+		uint64_t callStack; // Zero if not captured.
+		int64_t count; // Number of allocations, negative in a diff if some were freed.
+		int64_t bytes; // Number of bytes, negative in a diff if some were freed.
+	};
+	std::vector<Entry, AllocatorTracker::malloc_allocator<Entry>> entries; // Sorted by type, category, element type & call stack.
+	AllocatorTracker::CallStackMap callStacks; // Call stacks referenced by entries.
+
+	// Get the allocations made in after but not in before, with freed allocations as negative values.
+	static AllocatorSnapshot diff(const AllocatorSnapshot& before, const AllocatorSnapshot& after);
+	// Export the snapshot as json with resolved call stacks.
+	bool exportJSON(const char* path) const;
 };
 
 AllocatorTracker& getAllocatorTracker();
@@ -152,14 +228,14 @@ void AllocatorTracker::alignedAllocate(const void* const pointer, size_t count,
 	allocate(pointer, type, category, AllocationTrackingData::create<T>(count, alignment));
 }
 template <typename T> 
-void AllocatorTracker::reallocate(const void* const pOriginal, const void* const pNew, size_t count, AllocatorMemoryType type, AllocatorCategory category)
+size_t AllocatorTracker::reallocate(const void* const pOriginal, const void* const pNew, size_t count, AllocatorMemoryType type, AllocatorCategory category)
 {
-	reallocate(pOriginal, pNew, type, category, AllocationTrackingData::create<T>(count));
+	return reallocate(pOriginal, pNew, type, category, AllocationTrackingData::create<T>(count));
 }
 template <typename T> 
-void AllocatorTracker::alignedReallocate(const void* const pOriginal, const void* const pNew, size_t count, size_t alignment, AllocatorMemoryType type, AllocatorCategory category)
+size_t AllocatorTracker::alignedReallocate(const void* const pOriginal, const void* const pNew, size_t count, size_t alignment, AllocatorMemoryType type, AllocatorCategory category)
 {
-	reallocate(pOriginal, pNew, type, category, AllocationTrackingData::create<T>(count, alignment));
+	return reallocate(pOriginal, pNew, type, category, AllocationTrackingData::create<T>(count, alignment));
 }
 #endif
 
@@ -8,6 +8,8 @@ namespace aka {
 
 using byte_t = uint8_t;
 
+class LinearAllocator;
+
 class Memory
 {
 public:
@@ -59,6 +61,12 @@ namespace mem {
 
 Allocator& getAllocator(AllocatorMemoryType memory, AllocatorCategory category);
 
+// Get the frame arena of the calling thread, for scratch memory valid until the end of the frame.
+// Each thread has its own arena so that allocating from it does not need any synchronization.
+LinearAllocator& getFrameAllocator();
+// Reset the frame arenas of all threads. Must be called between frames, when no thread is using its arena.
+void resetFrameAllocators();
+
 // Override default new for memory tracking.
 template <typename T, typename ...Args> T*   akaNew(AllocatorMemoryType type, AllocatorCategory category, Args ...args);
 template <typename T>					void akaDelete(const T* pointer);
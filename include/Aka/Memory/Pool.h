@@ -5,6 +5,7 @@
 #include <functional>
 
 #include <Aka/Memory/Memory.h>
+#include <Aka/Core/Container/Vector.h>
 
 namespace aka {
 
@@ -42,6 +43,8 @@ private:
 	PoolIterator<T> m_begin, m_end;
 };
 
+// Pool of elements stored in fixed size blocks.
+// Each chunk knows its block & blocks with free chunks are kept in a list, so acquire & release are O(1) whatever the number of blocks.
 template <typename T, size_t ChunkCountPerBlock = 256>
 class Pool final
 {
@@ -65,6 +68,10 @@ public:
 	void release(std::function<void(T&)>&& deleter);
 	// Return number of acquired elements
 	size_t count() const;
+	// Return number of memory blocks
+	size_t getBlockCount() const;
+	// Visit acquired elements of a range of blocks
+	template <typename Func> void visit(size_t firstBlock, size_t blockCount, Func&& func);
 public:
 	// Return begin iterator
 	PoolIterator<T, ChunkCountPerBlock> begin();
@@ -72,29 +79,46 @@ public:
 	PoolIterator<T, ChunkCountPerBlock> end();
 private:
 	friend class PoolIterator<T, ChunkCountPerBlock>;
-	union Chunk {
+	struct Block;
+	struct Chunk {
 		Chunk() {}
-		~Chunk() {} 
-		Chunk* m_next;
-		T m_element; 
-	}; // TODO align this
+		~Chunk() {}
+		union {
+			Chunk* m_next; // Next free chunk of the block
+			T m_element;
+		}; // TODO align this
+		Block* m_block; // Block owning the chunk
+	};
 	struct Block {
 		Block() {}
 		~Block() {}
 		Chunk m_chunks[ChunkCountPerBlock];
 		uint8_t m_used[(ChunkCountPerBlock + 7) / 8]; // Bitmask for every element to check if it is currently used;
 		Block* m_next; // Next block if not enough space
+		Block* m_nextFree; // Next block with free chunks
+		Chunk* m_freeList; // Free list for next available chunk in the block.
 		size_t m_count; // Number of acquired elements for block
+		size_t m_index; // Index of the block in the pool
 
-		static Block* create(AllocatorType& _allocator);
+		static Block* create(AllocatorType& _allocator, size_t _index);
+		// Reset free list of the block so that all chunks are available
+		void resetFreeList();
 		// Check if chunk is used within block
 		bool isChunkUsed(const Chunk* _chunk) const;
 		// Get index of chunk in block
 		size_t getChunkIndex(const Chunk* _chunk) const;
 	};
+	// Add a new block at the end of the pool
+	Block* createBlock();
+	// Reset the list of blocks with free chunks to all blocks
+	void resetFreeBlocks();
+private:
 	AllocatorType& m_allocator;
 	Block* m_block; // Memory block to store objects.
-	Chunk* m_freeList; // Free list for next available item in the pool.
+	Block* m_lastBlock; // Last block of the list
+	Block* m_freeBlock; // List of blocks with free chunks.
+	Vector<Block*> m_blocks; // Blocks indexed by their index
+	size_t m_count; // Number of acquired elements
 };
 
 
@@ -108,28 +132,39 @@ inline Pool<T, ChunkCountPerBlock>::Pool() :
 template <typename T, size_t ChunkCountPerBlock>
 inline Pool<T, ChunkCountPerBlock>::Pool(AllocatorType& _allocator) :
 	m_allocator(_allocator),
-	m_block(Block::create(m_allocator)),
-	m_freeList(nullptr)
+	m_block(nullptr),
+	m_lastBlock(nullptr),
+	m_freeBlock(nullptr),
+	m_blocks(),
+	m_count(0)
 {
-	m_freeList = m_block->m_chunks;
+	createBlock();
 }
 
 template <typename T, size_t ChunkCountPerBlock>
-typename Pool<T, ChunkCountPerBlock>::Block* Pool<T, ChunkCountPerBlock>::Block::create(AllocatorType& _allocator)
+typename Pool<T, ChunkCountPerBlock>::Block* Pool<T, ChunkCountPerBlock>::Block::create(AllocatorType& _allocator, size_t _index)
 {
-	
 	Block* block = static_cast<Block*>(_allocator.allocate<Block>(1));
 	Memory::set(block->m_used, 0, sizeof(block->m_used));
 	block->m_next = nullptr;
+	block->m_nextFree = nullptr;
 	block->m_count = 0;
-	// Init data free list.
-	Chunk* start = block->m_chunks;
+	block->m_index = _index;
 	for (size_t index = 0; index < ChunkCountPerBlock; index++)
-		block->m_chunks[index].m_next = ++start;
-	block->m_chunks[ChunkCountPerBlock - 1].m_next = nullptr;
+		block->m_chunks[index].m_block = block;
+	block->resetFreeList();
 	return block;
 }
 
+template<typename T, size_t ChunkCountPerBlock>
+inline void Pool<T, ChunkCountPerBlock>::Block::resetFreeList()
+{
+	for (size_t index = 0; index < ChunkCountPerBlock - 1; index++)
+		m_chunks[index].m_next = &m_chunks[index + 1];
+	m_chunks[ChunkCountPerBlock - 1].m_next = nullptr;
+	m_freeList = m_chunks;
+}
+
 template<typename T, size_t ChunkCountPerBlock>
 inline bool Pool<T, ChunkCountPerBlock>::Block::isChunkUsed(const Chunk* _chunk) const
 {
@@ -145,84 +180,104 @@ inline size_t Pool<T, ChunkCountPerBlock>::Block::getChunkIndex(const Chunk* _ch
 	return (size_t)chunkIndex;
 }
 
+template<typename T, size_t ChunkCountPerBlock>
+inline typename Pool<T, ChunkCountPerBlock>::Block* Pool<T, ChunkCountPerBlock>::createBlock()
+{
+	Block* block = Block::create(m_allocator, m_blocks.size());
+	m_blocks.append(block);
+	if (m_lastBlock == nullptr)
+		m_block = block;
+	else
+		m_lastBlock->m_next = block;
+	m_lastBlock = block;
+	block->m_nextFree = m_freeBlock;
+	m_freeBlock = block;
+	return block;
+}
+
+template<typename T, size_t ChunkCountPerBlock>
+inline void Pool<T, ChunkCountPerBlock>::resetFreeBlocks()
+{
+	// Keep blocks order so that first blocks are filled first.
+	m_freeBlock = nullptr;
+	for (size_t iBlock = m_blocks.size(); iBlock > 0; iBlock--)
+	{
+		Block* block = m_blocks[iBlock - 1];
+		block->resetFreeList();
+		block->m_nextFree = m_freeBlock;
+		m_freeBlock = block;
+	}
+}
+
 template <typename T, size_t ChunkCountPerBlock>
 inline Pool<T, ChunkCountPerBlock>::~Pool()
 {
 	// Release all objects
 	release();
 	// Free memory
-	Block* nextBlock = m_block;
-	do
-	{
-		Block* currentBlock = nextBlock;
-		nextBlock = currentBlock->m_next;
-		m_allocator.deallocate(currentBlock);
-	} while (nextBlock != nullptr);
+	for (Block* block : m_blocks)
+		m_allocator.deallocate(block);
 }
 template <typename T, size_t ChunkCountPerBlock>
 template<typename ...Args>
 inline T* Pool<T, ChunkCountPerBlock>::acquire(Args&&... args)
 {
-	Block* block = m_block;
-	if (m_freeList == nullptr)
+	Block* block = m_freeBlock;
+	if (block == nullptr)
+		block = createBlock();
+	Chunk* p = block->m_freeList;
+	AKA_ASSERT(p != nullptr, "Full block in free block list");
+	block->m_freeList = p->m_next;
+	if (block->m_freeList == nullptr)
 	{
-		// Create new block and update freelist.
-		Block* lastBlock = m_block;
-		while (lastBlock->m_next != nullptr)
-			lastBlock = lastBlock->m_next;
-		lastBlock->m_next = Block::create(m_allocator);
-		m_freeList = lastBlock->m_next->m_chunks;
-		block = lastBlock->m_next;
+		// Block is full, remove it from the list.
+		m_freeBlock = block->m_nextFree;
+		block->m_nextFree = nullptr;
 	}
-	else
-	{
-		// Find block used by freelist currently
-		while (block != nullptr && (((uintptr_t)m_freeList < (uintptr_t)block->m_chunks) || ((uintptr_t)m_freeList > ((uintptr_t)&block->m_chunks[ChunkCountPerBlock - 1]))))
-			block = block->m_next;
-		AKA_ASSERT(block != nullptr, "m_freeList not in any block");
-	}
-	Chunk* p = m_freeList;
-	m_freeList = m_freeList->m_next;
 	new (&p->m_element) T(std::forward<Args>(args)...); // Call constructor with new placement
 	// Set used bitmask
 	size_t index = p - block->m_chunks;
 	block->m_used[index / 8] |= 0x01 << (index % 8);
 	// Register the new element
 	block->m_count++;
+	m_count++;
 	return &p->m_element;
 }
 
 template <typename T, size_t ChunkCountPerBlock>
 inline void Pool<T, ChunkCountPerBlock>::release(T* element)
 {
-	Block* block = m_block;
-	while (block != nullptr && (((uintptr_t)element < (uintptr_t)block->m_chunks) || ((uintptr_t)element > ((uintptr_t)&block->m_chunks[ChunkCountPerBlock - 1]))))
-		block = block->m_next;
-	AKA_ASSERT(block != nullptr, "m_freeList not in any block");
-	//if (block == nullptr)
-	//	return; // Element not from pool
-
+	// Element is the first member of its chunk.
 	Chunk* chunk = reinterpret_cast<Chunk*>(element);
+	Block* block = chunk->m_block;
+	AKA_ASSERT(block != nullptr && block->m_index < m_blocks.size() && m_blocks[block->m_index] == block, "Element not in any block");
+
 	size_t index = chunk - block->m_chunks;
 	if (block->m_used[index / 8] & (0x01 << (index % 8)))
 	{
 		if constexpr (std::is_destructible<T>::value)
 			element->~T(); // Call destructor
-		chunk->m_next = m_freeList;
-		m_freeList = chunk;
+		if (block->m_freeList == nullptr)
+		{
+			// Block was full, add it back to the list.
+			block->m_nextFree = m_freeBlock;
+			m_freeBlock = block;
+		}
+		chunk->m_next = block->m_freeList;
+		block->m_freeList = chunk;
 		// Set used bitmask
 		block->m_used[index / 8] &= ~(0x01 << (index % 8));
 		// Unregister the new element
 		AKA_ASSERT(block->m_count > 0, "System error");
 		block->m_count--;
+		m_count--;
 	}
 }
 
 template <typename T, size_t ChunkCountPerBlock>
 inline void Pool<T, ChunkCountPerBlock>::release()
 {
-	Block* currentBlock = m_block;
-	do
+	for (Block* currentBlock : m_blocks)
 	{
 		size_t count = 0;
 		if constexpr (std::is_destructible<T>::value)
@@ -237,29 +292,20 @@ inline void Pool<T, ChunkCountPerBlock>::release()
 					count++;
 				}
 			}
-			// Reset freelist content
-			m_freeList = chunks;
-			for (size_t index = 0; index < ChunkCountPerBlock; index++)
-				m_freeList[index].m_next = ++chunks;
-			m_freeList[ChunkCountPerBlock - 1].m_next = currentBlock->m_next == nullptr ? nullptr : currentBlock->m_next->m_chunks;
+			AKA_ASSERT(currentBlock->m_count == count, "Invalid count");
 		}
 		// Set used bitmask
 		memset(currentBlock->m_used, 0, sizeof(currentBlock->m_used));
-
-		AKA_ASSERT(currentBlock->m_count == count, "Invalid count");
 		currentBlock->m_count = 0;
-
-		currentBlock = currentBlock->m_next;
-	} while (currentBlock != nullptr);
-
-	// Reset freelist start
-	m_freeList = m_block->m_chunks;
+	}
+	m_count = 0;
+	// Reset freelists
+	resetFreeBlocks();
 }
 template <typename T, size_t ChunkCountPerBlock>
 inline void Pool<T, ChunkCountPerBlock>::release(std::function<void(T&)>&& deleter)
 {
-	Block* currentBlock = m_block;
-	do
+	for (Block* currentBlock : m_blocks)
 	{
 		size_t count = 0;
 		Chunk* chunks = currentBlock->m_chunks;
@@ -274,36 +320,43 @@ inline void Pool<T, ChunkCountPerBlock>::release(std::function<void(T&)>&& delet
 				count++;
 			}
 		}
-		// Reset freelist content
-		m_freeList = chunks;
-		for (size_t index = 0; index < ChunkCountPerBlock; index++)
-			m_freeList[index].m_next = ++chunks;
-		m_freeList[ChunkCountPerBlock - 1].m_next = currentBlock->m_next == nullptr ? nullptr : currentBlock->m_next->m_chunks;
-
 		// Set used bitmask
 		memset(currentBlock->m_used, 0, sizeof(currentBlock->m_used));
 
 		AKA_ASSERT(currentBlock->m_count == count, "Invalid count");
 		currentBlock->m_count = 0;
-
-		currentBlock = currentBlock->m_next;
-	} while (currentBlock != nullptr);
-
-	// Reset freelist start
-	m_freeList = m_block->m_chunks;
+	}
+	m_count = 0;
+	// Reset freelists
+	resetFreeBlocks();
 }
 
 template<typename T, size_t ChunkCountPerBlock>
 inline size_t aka::Pool<T, ChunkCountPerBlock>::count() const
 {
-	Block* currentBlock = m_block;
-	size_t count = 0;
-	do
+	return m_count;
+}
+template<typename T, size_t ChunkCountPerBlock>
+inline size_t Pool<T, ChunkCountPerBlock>::getBlockCount() const
+{
+	return m_blocks.size();
+}
+template<typename T, size_t ChunkCountPerBlock>
+template<typename Func>
+inline void Pool<T, ChunkCountPerBlock>::visit(size_t firstBlock, size_t blockCount, Func&& func)
+{
+	const size_t lastBlock = min<size_t>(firstBlock + blockCount, m_blocks.size());
+	for (size_t iBlock = firstBlock; iBlock < lastBlock; iBlock++)
 	{
-		count += currentBlock->m_count;
-		currentBlock = currentBlock->m_next;
-	} while (currentBlock != nullptr);
-	return count;
+		Block* currentBlock = m_blocks[iBlock];
+		if (currentBlock->m_count == 0)
+			continue;
+		for (size_t index = 0; index < ChunkCountPerBlock; index++)
+		{
+			if (currentBlock->m_used[index / 8] & (0x01 << (index % 8)))
+				func(currentBlock->m_chunks[index].m_element);
+		}
+	}
 }
 template<typename T, size_t ChunkCountPerBlock>
 PoolIterator<T, ChunkCountPerBlock> Pool<T, ChunkCountPerBlock>::begin() {
@@ -311,9 +364,7 @@ PoolIterator<T, ChunkCountPerBlock> Pool<T, ChunkCountPerBlock>::begin() {
 }
 template<typename T, size_t ChunkCountPerBlock>
 PoolIterator<T, ChunkCountPerBlock> Pool<T, ChunkCountPerBlock>::end() {
-	Block* endBlock = m_block;
-	while (endBlock->m_next != nullptr)
-		endBlock = endBlock->m_next;
+	Block* endBlock = m_lastBlock;
 
 	// TODO: need to take the last NON EMPTY block or it will be an issue.
 	// Could move count to block instead of pool for that.
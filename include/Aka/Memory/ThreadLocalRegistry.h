@@ -0,0 +1,120 @@
+#pragma once
+
+#include <mutex>
+
+#include <Aka/Core/Container/Vector.h>
+
+namespace aka {
+
+// Registry of objects owned by a single thread at a time.
+// Objects of exited threads are kept & reused by new threads, so that memory they handed out outlives the thread.
+// All objects are destroyed with the registry.
+template <typename T>
+class ThreadLocalRegistry
+{
+public:
+	using CreateFunc = T*(*)();
+	using DestroyFunc = void(*)(T*);
+	using ReleaseFunc = void(*)(T*);
+
+	ThreadLocalRegistry(CreateFunc _create, DestroyFunc _destroy, ReleaseFunc _release = nullptr);
+	ThreadLocalRegistry(const ThreadLocalRegistry&) = delete;
+	ThreadLocalRegistry& operator=(const ThreadLocalRegistry&) = delete;
+	~ThreadLocalRegistry();
+
+	// Get an object not owned by any thread, creating it if none is available.
+	T* acquire();
+	// Give back an object when its thread exits.
+	void release(T* _object);
+	// Call func(object) on every object, owned or not.
+	template <typename Func> void forEach(Func&& _func);
+private:
+	struct Entry
+	{
+		T* object;
+		bool used;
+	};
+	CreateFunc m_create;
+	DestroyFunc m_destroy;
+	ReleaseFunc m_release; // Called on objects given back, can be null.
+	std::mutex m_mutex;
+	Vector<Entry> m_entries;
+};
+
+// Object of the current thread, given back to its registry when the thread exits.
+// Meant to be declared static thread_local.
+template <typename T>
+class ThreadLocalRegistryEntry
+{
+public:
+	explicit ThreadLocalRegistryEntry(ThreadLocalRegistry<T>& _registry) : m_registry(_registry), m_object(_registry.acquire()) {}
+	ThreadLocalRegistryEntry(const ThreadLocalRegistryEntry&) = delete;
+	ThreadLocalRegistryEntry& operator=(const ThreadLocalRegistryEntry&) = delete;
+	~ThreadLocalRegistryEntry() { m_registry.release(m_object); }
+
+	T* get() const { return m_object; }
+private:
+	ThreadLocalRegistry<T>& m_registry;
+	T* m_object;
+};
+
+template <typename T>
+ThreadLocalRegistry<T>::ThreadLocalRegistry(CreateFunc _create, DestroyFunc _destroy, ReleaseFunc _release) :
+	m_create(_create),
+	m_destroy(_destroy),
+	m_release(_release),
+	m_mutex(),
+	m_entries()
+{
+}
+
+template <typename T>
+ThreadLocalRegistry<T>::~ThreadLocalRegistry()
+{
+	for (Entry& entry : m_entries)
+		m_destroy(entry.object);
+}
+
+template <typename T>
+T* ThreadLocalRegistry<T>::acquire()
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	for (Entry& entry : m_entries)
+	{
+		if (!entry.used)
+		{
+			entry.used = true;
+			return entry.object;
+		}
+	}
+	T* object = m_create();
+	m_entries.append(Entry{ object, true });
+	return object;
+}
+
+template <typename T>
+void ThreadLocalRegistry<T>::release(T* _object)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	for (Entry& entry : m_entries)
+	{
+		if (entry.object == _object)
+		{
+			if (m_release != nullptr)
+				m_release(_object);
+			entry.used = false;
+			return;
+		}
+	}
+}
+
+template <typename T>
+template <typename Func>
+void ThreadLocalRegistry<T>::forEach(Func&& _func)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	for (Entry& entry : m_entries)
+		_func(entry.object);
+}
+
+};
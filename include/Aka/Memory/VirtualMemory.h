@@ -0,0 +1,34 @@
+#pragma once
+
+#include <Aka/Core/Config.h>
+
+namespace aka {
+
+// Access to OS virtual memory.
+// Address ranges are reserved without consuming physical memory, and pages are committed on demand.
+// Addresses & sizes passed to commit & decommit must be aligned on page size.
+struct VirtualMemory
+{
+	// Get the size of a page
+	static size_t getPageSize();
+	// Get the size of a large page, 0 if not supported by the system.
+	static size_t getLargePageSize();
+
+	// Reserve an address range without committing memory. Return nullptr on failure.
+	static void* reserve(size_t size);
+	// Commit pages of a reserved range so that they can be accessed. Committed memory is zeroed.
+	static bool commit(void* address, size_t size);
+	// Decommit pages of a reserved range, giving physical memory back to the OS. Range stays reserved.
+	static bool decommit(void* address, size_t size);
+	// Release a range returned by reserve or allocateLargePages.
+	static void release(void* address, size_t size);
+
+	// Reserve & commit a range backed by large pages. Size must be aligned on large page size.
+	// Return nullptr if large pages are not available, which might require privileges.
+	static void* allocateLargePages(size_t size);
+
+	// Round size up to a multiple of the page size
+	static size_t alignToPageSize(size_t size);
+};
+
+};
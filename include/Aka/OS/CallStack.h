@@ -0,0 +1,25 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+namespace aka {
+
+// Return addresses of the call stack of a thread.
+// Capture does not allocate any tracked memory, so that it can be used from allocators.
+struct CallStack
+{
+	static constexpr uint32_t MaxDepth = 32;
+
+	void* frames[MaxDepth];
+	uint32_t depth;
+
+	// Capture the call stack of the calling thread, skipping its first frames.
+	static CallStack capture(uint32_t skip = 0);
+	// Hash of the frames, to deduplicate identical call stacks.
+	uint64_t hash() const;
+	// Resolve the symbol of a frame into a null terminated buffer.
+	static void resolve(const void* frame, char* buffer, size_t size);
+};
+
+};
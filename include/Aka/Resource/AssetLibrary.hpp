@@ -30,7 +30,7 @@ class ResourceIterator
 	using Iterator = typename HashMap<AssetID, ResourceHandle<T>>::iterator;
 	static_assert(std::is_base_of<Resource, T>::value, "This should inherit Resource");
 public:
-	explicit ResourceIterator(Iterator& value) : m_value(value) {}
+	explicit ResourceIterator(const Iterator& value) : m_value(value) {}
 	ResourceIterator& operator++()
 	{
 		m_value++;
@@ -66,7 +66,7 @@ struct AssetIterator {
 private:
 	using Iterator = HashMap<AssetID, AssetInfo>::iterator;
 public:
-	explicit AssetIterator(Iterator& value) : m_value(value) {}
+	explicit AssetIterator(const Iterator& value) : m_value(value) {}
 	AssetIterator& operator++()
 	{
 		m_value++;
@@ -4,6 +4,8 @@
 #include <Aka/Core/Container/String.h>
 #include <Aka/Memory/Pool.h>
 #include <Aka/Scene/NodeAllocator.hpp>
+#include <Aka/Scene/Query.hpp>
+#include <Aka/Scene/SystemScheduler.hpp>
 
 namespace aka {
 
@@ -31,6 +33,19 @@ public:
 	Node* createChild(Node* parent, const char* name);
 	void destroyChild(Node* node);
 
+	// Query nodes having all given components
+	template <typename... Components> Query<Components...> query() { return Query<Components...>(m_allocator); }
+	// Get the current frame, to query components changed since then
+	uint32_t getFrame() const { return m_allocator.getFrame(); }
+	// Get the components of a type added, removed or modified since given frame
+	template <typename C> ChangeRange getChanges(uint32_t _frame) const { return m_allocator.getComponentAllocator(Component<C, typename C::Archive>::getComponentID()).getJournal().getChanges(_frame); }
+	// Get the nodes which world transform changed since given frame
+	ChangeRange getTransformChanges(uint32_t _frame) const { return m_allocator.getTransformJournal().getChanges(_frame); }
+	// Set the pool running component updates that do not conflict in parallel, nullptr to run them on calling thread.
+	void setWorkerPool(WorkerPool* _pool) { m_workerPool = _pool; }
+	// Get the scheduler of component updates, with their timings
+	const SystemScheduler& getScheduler() const { return m_scheduler; }
+
 	// TODO: getmainCameraNode should be determined with cameracomponent :: main
 	const Node* getMainCameraNode() const { return m_mainCamera; }
 	void setMainCameraNode(Node* node);
@@ -39,6 +54,8 @@ private:
 	NodeAllocator m_allocator;
 	Node* m_mainCamera;
 	Node* m_root;
+	SystemScheduler m_scheduler;
+	WorkerPool* m_workerPool;
 };
 
 
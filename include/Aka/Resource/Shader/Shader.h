@@ -83,15 +83,14 @@ struct std::hash<aka::ShaderKey>
 {
 	size_t operator()(const aka::ShaderKey& key) const
 	{
-		size_t hash = 0;
-		aka::hash::fnv(hash, key.entryPoint.cstr(), key.entryPoint.length());
+		size_t hash = aka::hash::buffer(key.entryPoint.cstr(), key.entryPoint.length());
 		for (auto& shader : key.macros)
 		{
-			aka::hash::fnv(hash, shader.key.cstr(), shader.key.length());
-			aka::hash::fnv(hash, shader.value.cstr(), shader.value.length());
+			hash = aka::hash::buffer(shader.key.cstr(), shader.key.length(), hash);
+			hash = aka::hash::buffer(shader.value.cstr(), shader.value.length(), hash);
 		}
-		aka::hash::fnv(hash, key.path.cstr(), key.path.size());
-		aka::hash::fnv(hash, &key.type, sizeof(aka::gfx::ShaderType));
+		hash = aka::hash::buffer(key.path.cstr(), key.path.size(), hash);
+		aka::hash::combine(hash, key.type);
 		return hash;
 	}
 };
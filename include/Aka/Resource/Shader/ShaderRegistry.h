@@ -6,7 +6,7 @@
 #include <Aka/Resource/Shader/ShaderCompiler.h>
 #include <Aka/OS/FileWatcher.hpp>
 
-#include <unordered_map>
+#include <Aka/Core/Container/HashMap.hpp>
 #include <mutex>
 
 #define AKA_SHADER_HOT_RELOAD 1
@@ -52,15 +52,15 @@ public:
 	void reloadIfChanged(gfx::GraphicDevice* device);
 #endif
 
-	std::unordered_map<ProgramKey, gfx::ProgramHandle>::iterator begin() { return m_programs.begin(); }
-	std::unordered_map<ProgramKey, gfx::ProgramHandle>::iterator end() { return m_programs.end(); }
-	std::unordered_map<ProgramKey, gfx::ProgramHandle>::const_iterator begin() const { return m_programs.begin(); }
-	std::unordered_map<ProgramKey, gfx::ProgramHandle>::const_iterator end() const { return m_programs.end(); }
+	HashMap<ProgramKey, gfx::ProgramHandle>::iterator begin() { return m_programs.begin(); }
+	HashMap<ProgramKey, gfx::ProgramHandle>::iterator end() { return m_programs.end(); }
+	HashMap<ProgramKey, gfx::ProgramHandle>::const_iterator begin() const { return m_programs.begin(); }
+	HashMap<ProgramKey, gfx::ProgramHandle>::const_iterator end() const { return m_programs.end(); }
 private:
 	ShaderCompiler m_compiler;
-	std::unordered_map<ShaderKey, ShaderFileData> m_shadersFileData;
-	std::unordered_map<ShaderKey, gfx::ShaderHandle> m_shaders;
-	std::unordered_map<ProgramKey, gfx::ProgramHandle> m_programs;
+	HashMap<ShaderKey, ShaderFileData> m_shadersFileData;
+	HashMap<ShaderKey, gfx::ShaderHandle> m_shaders;
+	HashMap<ProgramKey, gfx::ProgramHandle> m_programs;
 #if defined(AKA_SHADER_HOT_RELOAD)
 	FileWatcher m_fileWatcher;
 	std::mutex m_fileWatcherMutex;
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <mutex>
+
+#include <Aka/Core/Container/Vector.h>
+#include <Aka/Core/Container/SlotMap.h>
+
+namespace aka {
+
+class Node;
+using NodeHandle = SlotHandle<Node*>;
+
+enum class ChangeType : uint8_t
+{
+	Added, // Component attached to node
+	Removed, // Component detached from node, which might be destroyed already
+	Modified, // Component marked dirty, recorded once per frame
+	TransformUpdated, // World transform of node changed
+};
+
+struct ChangeEvent
+{
+	NodeHandle node;
+	ChangeType type;
+	uint32_t frame;
+};
+
+// Changes recorded since a frame, ordered by frame.
+class ChangeRange
+{
+public:
+	ChangeRange(const ChangeEvent* _begin, const ChangeEvent* _end, bool _complete) : m_begin(_begin), m_end(_end), m_complete(_complete) {}
+	const ChangeEvent* begin() const { return m_begin; }
+	const ChangeEvent* end() const { return m_end; }
+	size_t size() const { return m_end - m_begin; }
+	// Some changes were trimmed from the journal, consumers should resync their whole state.
+	bool isComplete() const { return m_complete; }
+private:
+	const ChangeEvent* m_begin;
+	const ChangeEvent* m_end;
+	bool m_complete;
+};
+
+// Journal of changes stamped with the frame they happened, so that consumers can process deltas since the last frame they saw.
+// Changes can be recorded from multiple threads, their order inside a frame is not guaranteed then.
+// Old frames are trimmed to bound memory, so consumers lagging behind are told to resync.
+class ChangeJournal
+{
+public:
+	ChangeJournal();
+	ChangeJournal(const ChangeJournal&) = delete;
+	ChangeJournal& operator=(const ChangeJournal&) = delete;
+	~ChangeJournal();
+
+	// Record a change of a node at given frame, which should not be older than previous ones.
+	void record(NodeHandle _node, ChangeType _type, uint32_t _frame);
+	// Drop changes older than given frame
+	void trim(uint32_t _frame);
+	// Get changes recorded at given frame or after. Not thread safe with record.
+	ChangeRange getChanges(uint32_t _frame) const;
+	// Get the oldest frame which changes are all recorded
+	uint32_t getFirstFrame() const { return m_firstFrame; }
+private:
+	std::mutex m_mutex;
+	Vector<ChangeEvent, AllocatorCategory::Component> m_changes;
+	uint32_t m_firstFrame;
+};
+
+};
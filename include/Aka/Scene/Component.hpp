@@ -21,9 +21,6 @@ struct Archive;
 struct ArchiveComponent;
 
 
-using ComponentSet = TreeSet<ComponentID>;
-using ComponentMap = TreeMap<ComponentID, ComponentBase*>;
-
 struct ArchiveComponent
 {
 	ArchiveComponent(ComponentID componentID, ArchiveComponentVersionType version);
@@ -89,8 +86,8 @@ protected:
 	// When update to renderer are required.
 	virtual void onRenderUpdate(AssetLibrary* library, Renderer* _renderer) { unregisterForUpdates(ComponentUpdateFlags::RenderUpdate); }
 public:
-	// Mark component as dirty
-	void setDirty() { m_dirty = true; }
+	// Mark component as dirty & changed this frame
+	void setDirty();
 	// Check if component is dirty
 	bool isDirty() const { return m_dirty; }
 protected:
@@ -166,7 +163,7 @@ const char* Component<T, A>::getName() {
 }
 template <typename T, typename A>
 ComponentID Component<T, A>::getComponentID() {
-	static const ComponentID id = static_cast<ComponentID>(WSID(getName()));
+	static const ComponentID id = static_cast<ComponentID>(WSID_runtime(getName()));
 	return id;
 }
 template <typename T, typename A>
@@ -37,6 +37,8 @@ public:
 	void onBecomeActive(AssetLibrary* library, Renderer* _renderer) override;
 	void onBecomeInactive(AssetLibrary* library, Renderer* _renderer) override;
 	void onUpdate(Time deltaTime) override;
+	// Move its node & its childs
+	static SystemAccess getSystemAccess() { return SystemAccess().write(SystemResource::Transforms); }
 public:
 	void fromArchive(const ArchiveArcballComponent& archive) override;
 	void toArchive(ArchiveArcballComponent& archive) override;
@@ -142,6 +142,8 @@ public:
 	void onBecomeInactive(AssetLibrary* library, Renderer* _renderer) override;
 	void onUpdate(Time deltaTime) override;
 	void onRenderUpdate(AssetLibrary* library, Renderer* _renderer) override;
+	// Send its view to the renderer
+	static SystemAccess getSystemAccess() { return SystemAccess().read(SystemResource::Transforms).write(SystemResource::Renderer); }
 public:
 	void fromArchive(const ArchiveCameraComponent& archive) override;
 	void toArchive(ArchiveCameraComponent& archive) override;
@@ -82,6 +82,8 @@ public:
 	void onBecomeInactive(AssetLibrary* library, Renderer* _renderer) override;
 	void onRenderUpdate(AssetLibrary* library, Renderer* _renderer) override;
 	void onUpdate(Time _time) override;
+	// Contacts are computed by rigid bodies
+	static SystemAccess getSystemAccess() { return SystemAccess().parallel(); }
 
 public:
 	ContactData computeContactData(ColliderComponent& _other);
@@ -26,6 +26,8 @@ public:
 	void onBecomeActive(AssetLibrary* library, Renderer* _renderer) override;
 	void onBecomeInactive(AssetLibrary* library, Renderer* _renderer) override;
 	void onRenderUpdate(AssetLibrary* library, Renderer* _renderer) override;
+	// Send its world transform to the renderer
+	static SystemAccess getSystemAccess() { return SystemAccess().read(SystemResource::Transforms).write(SystemResource::Renderer); }
 
 	ResourceHandle<StaticMesh> getMesh() const;
 	aabbox<> getWorldBounds() const;
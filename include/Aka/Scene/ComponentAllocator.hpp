@@ -1,7 +1,10 @@
 #pragma once 
 
 #include <Aka/Core/Container/HashMap.hpp>
+#include <Aka/Core/Container/Vector.h>
 #include <Aka/Scene/ComponentType.hpp>
+#include <Aka/Scene/ChangeJournal.hpp>
+#include <Aka/Scene/SystemAccess.hpp>
 #include <Aka/Memory/Pool.h>
 
 namespace aka {
@@ -21,13 +24,50 @@ public:
 	virtual ComponentBase* allocateBase(Node* _node) = 0;
 	virtual void deallocateBase(ComponentBase* _component) = 0;
 	virtual void visitPool(std::function<void(ComponentBase&)> _callback) = 0;
+	// Get the data accessed by updates of this component type
+	virtual SystemAccess getSystemAccess() const = 0;
 
 	const char* getName() const { return m_name;  }
+public: // Sparse set of attached components, indexed by node slot.
+	// Get the component attached to a node, nullptr if none.
+	ComponentBase* find(uint32_t _nodeIndex) const;
+	// Register a component as attached to a node, changed at given frame.
+	void insert(uint32_t _nodeIndex, Node* _node, ComponentBase* _component, uint32_t _frame);
+	// Unregister the component attached to a node, removed at given frame.
+	void erase(uint32_t _nodeIndex, uint32_t _frame);
+	// Mark the component attached to a node as changed at given frame. Thread safe for different nodes.
+	void setChanged(uint32_t _nodeIndex, uint32_t _frame);
+	// Get the last frame the component attached to a node changed.
+	uint32_t getChangedFrame(uint32_t _nodeIndex) const;
+	// Get the number of attached components
+	size_t count() const { return m_components.size(); }
+	// Get the attached components, densely packed.
+	ComponentBase* const* getComponents() const { return m_components.data(); }
+	// Get the nodes of the attached components, in the same order.
+	Node* const* getNodes() const { return m_nodes.data(); }
+	// Get the last frame the attached components changed, in the same order.
+	const uint32_t* getChangedFrames() const { return m_changedFrames.data(); }
+	// Get the journal of components added, removed & modified
+	ChangeJournal& getJournal() { return m_journal; }
+	// Get the journal of components added, removed & modified
+	const ChangeJournal& getJournal() const { return m_journal; }
 private:
+	static constexpr uint32_t InvalidIndex = ~0U;
 	ComponentID m_componentID;
 	const char* m_name;
+	Vector<uint32_t, AllocatorCategory::Component> m_sparse; // Dense index of each node slot
+	Vector<ComponentBase*, AllocatorCategory::Component> m_components;
+	Vector<Node*, AllocatorCategory::Component> m_nodes;
+	Vector<uint32_t, AllocatorCategory::Component> m_changedFrames;
+	ChangeJournal m_journal;
 };
 
+// Check if a component type declare the data accessed by its updates
+template <typename T, typename = void>
+struct HasSystemAccess : std::false_type {};
+template <typename T>
+struct HasSystemAccess<T, std::void_t<decltype(T::getSystemAccess())>> : std::true_type {};
+
 template<typename T>
 class ComponentAllocator : public ComponentAllocatorBase
 {
@@ -47,6 +87,13 @@ public:
 		m_pool.release(_component);
 	}
 	ComponentAllocatorBase* clone() const override;
+	SystemAccess getSystemAccess() const override
+	{
+		if constexpr (HasSystemAccess<T>::value)
+			return T::getSystemAccess();
+		else
+			return SystemAccess::all();
+	}
 	PoolIterator<T> begin() { return m_pool.begin(); }
 	PoolIterator<T> end() { return m_pool.end(); }
 protected:
@@ -79,6 +126,7 @@ public:
 
 	void add(ComponentID _componentID, ComponentAllocatorBase* _componentAllocator);
 	ComponentAllocatorBase* get(ComponentID _componentID);
+	const ComponentAllocatorBase* get(ComponentID _componentID) const;
 	void visit(std::function<void(ComponentAllocatorBase*)> _callback);
 private:
 	Allocator& m_allocator;
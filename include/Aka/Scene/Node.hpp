@@ -2,21 +2,28 @@
 
 #include <Aka/Core/Container/String.h>
 #include <Aka/Core/Container/Vector.h>
+#include <Aka/Core/Container/SmallVector.h>
+#include <Aka/Core/Container/SlotMap.h>
+#include <Aka/Core/StringTable.hpp>
 #include <Aka/Memory/Pool.h>
 
 #include <Aka/Scene/Component.hpp>
+#include <Aka/Scene/TransformHierarchy.hpp>
 
 namespace aka {
 
 class NodeAllocator;
+class Node;
+
+// Generational handle to a node, detect destroyed nodes instead of dangling.
+using NodeHandle = SlotHandle<Node*>;
 
 enum class NodeUpdateFlag : uint32_t
 {
 	None				= 0,
 
 	TransformUpdated	= 1 << 0,
-	TransformDirty		= 1 << 1,
-	HierarchyUpdated	= 1 << 2,
+	HierarchyUpdated	= 1 << 1,
 };
 AKA_IMPLEMENT_BITMASK_OPERATOR(NodeUpdateFlag);
 
@@ -31,7 +38,14 @@ public:
 	Node(const char* name, NodeAllocator* _allocator);
 	virtual ~Node();
 
+	// Attach an allocated component to the entity
 	void attach(ComponentBase* component);
+	// Detach a component from the entity.
+	void detach(ComponentID componentID);
+	// Find an attached component, nullptr if none. O(1)
+	ComponentBase* findComponent(ComponentID componentID);
+	// Find an attached component, nullptr if none. O(1)
+	const ComponentBase* findComponent(ComponentID componentID) const;
 	// Attach a component to the entity
 	template <typename T> T& attach();
 	// Detach a component from the entity.
@@ -56,11 +70,13 @@ public:
 	void finishUpdate();
 public:
 	// Get node name
-	const String& getName() const { return m_name; }
+	const char* getName() const { return getStringTable().getString(m_name); }
+	// Get node name ID, for fast comparisons
+	StringID getNameID() const { return m_name; }
 	// Does the node has active components
-	bool isOrphan() const { return m_componentsActive.size() == 0; }
-	// Get the active components
-	const ComponentMap& getComponentMap() const { return m_componentsActive; }
+	bool isOrphan() const;
+	// Get the attached components
+	const SmallVector<ComponentBase*, 4>& getComponents() const { return m_components; }
 	// Mark a component as dirty
 	template<typename T> void setDirty();
 	// Set update flag
@@ -71,6 +87,8 @@ public:
 	bool has(NodeUpdateFlag flag) const { return asBool(m_updateFlags & flag); }
 	// Get node allocator
 	NodeAllocator& getAllocator() { return *m_allocator; }
+	// Get node handle, resolved with NodeAllocator::get
+	NodeHandle getHandle() const { return m_handle; }
 public:
 	// Remove the node from the free, set its childs to its parent
 	void unlink();
@@ -96,10 +114,10 @@ public:
 	void visitAllChildrens(std::function<void(Node*)> _callback);
 private: // Hierarchy
 	Node* m_parent;
-	Vector<Node*> m_childrens;
+	SmallVector<Node*, 4> m_childrens; // Most nodes have few childrens
 
 public: // Transforms
-	// Set local transform
+	// Set local transform. World transform of childs is computed now or on next scene update.
 	void setLocalTransform(const mat4f& transform, bool _computeWorld = true);
 	// Get the local transform
 	const mat4f& getLocalTransform() const;
@@ -107,142 +125,74 @@ public: // Transforms
 	const mat4f& getWorldTransform() const;
 	// Get the parent transform
 	mat4f getParentTransform() const;
+	// Get the transform ID in the node allocator hierarchy
+	TransformID getTransformID() const { return m_transform; }
 private:
-	mat4f computeWorldTransform() const;
-
-	mat4f m_localTransform;
-	mat4f m_cacheWorldTransform;
+	TransformID m_transform; // Matrices are stored in the allocator hierarchy
 private: // Data
-	String m_name;
-	ComponentSet m_componentIDs;
-	ComponentMap m_componentsActive;
-	ComponentMap m_componentsToActivate;
-	ComponentMap m_componentsToDeactivate;
+	StringID m_name; // Interned as many nodes share the same name
+	// Components are indexed by node in the allocator, these are only used to iterate them.
+	SmallVector<ComponentBase*, 4> m_components; // Attached components
+	SmallVector<ComponentBase*, 2> m_componentsToActivate; // Attached components waiting for activation
+	SmallVector<ComponentBase*, 2> m_componentsToDeactivate; // Detached components waiting for deactivation
 private:
+	// Allocate a component from the node allocator
+	ComponentBase* allocateComponent(ComponentID componentID);
+	friend class NodeAllocator;
 	NodeAllocator* m_allocator;
+	NodeHandle m_handle;
 	NodeUpdateFlag m_updateFlags;
 };
 
 template<typename T>
 inline T& Node::attach()
 {
-	static_assert(std::is_base_of<Component<T, T::Archive>, T>::value, "Invalid type");
-	ComponentID id = Component<T, T::Archive>::getComponentID();
+	static_assert(std::is_base_of<Component<T, typename T::Archive>, T>::value, "Invalid type");
 	AKA_ASSERT(!has<T>(), "Trying to attach already attached component");
-	m_componentIDs.insert(id);
-	T* component = m_allocator->allocate<T>(this);
-	component->onAttach();
-	m_componentsToActivate.insert(std::make_pair(id, component));
+	T* component = reinterpret_cast<T*>(allocateComponent(Component<T, typename T::Archive>::getComponentID()));
+	attach(component);
 	return *component;
 }
 
 template<typename T>
 inline void Node::detach()
 {
-	static_assert(std::is_base_of<Component<T, T::Archive>, T>::value, "Invalid type");
-	const ComponentID componentID = Component<T, T::Archive>::getComponentID();
-	AKA_ASSERT(has<T>(), "Trying to detach non attached component");
-	auto itActive = m_componentsActive.find(componentID);
-	m_componentIDs.erase(componentID);
-	if (itActive != m_componentsActive.end())
-	{
-		// Component still active until deactivate was call on it.
-		m_componentsToDeactivate.insert(std::make_pair(componentID, itActive->second));
-		m_componentsActive.erase(componentID);
-		return;
-	}
-	auto itToActivate = m_componentsToActivate.find(componentID);
-	if (itToActivate != m_componentsToActivate.end())
-	{
-		// Component still active until deactivate was call on it.
-		m_componentsToDeactivate.insert(std::make_pair(componentID, itToActivate->second));
-		m_componentsToActivate.erase(itToActivate);
-		return;
-	}
-	auto itToDeactivate = m_componentsToDeactivate.find(componentID);
-	if (itToDeactivate != m_componentsToDeactivate.end())
-	{
-		AKA_ASSERT(false, "Trying to detach already detached component");
-	}
-	else
-	{
-		AKA_CRASH("Trying to detach non attached component");
-	}
+	static_assert(std::is_base_of<Component<T, typename T::Archive>, T>::value, "Invalid type");
+	detach(Component<T, typename T::Archive>::getComponentID());
 }
 
 template<typename T>
 inline T& Node::get()
 {
-	static_assert(std::is_base_of<Component<T, T::Archive>, T>::value, "Invalid type");
-	const ComponentID componentID = Component<T, T::Archive>::getComponentID();
-	AKA_ASSERT(has<T>(), "Trying to get non attached component");
-	auto itActive = m_componentsActive.find(componentID);
-	if (itActive != m_componentsActive.end())
-	{
-		return *reinterpret_cast<T*>(itActive->second);
-	}
-	auto itToActivate = m_componentsToActivate.find(componentID);
-	if (itToActivate != m_componentsToActivate.end())
-	{
-		return *reinterpret_cast<T*>(itToActivate->second);
-	}
-	auto itToDeactivate = m_componentsToDeactivate.find(componentID);
-	if (itToDeactivate != m_componentsToDeactivate.end())
-	{
-		return *reinterpret_cast<T*>(itToDeactivate->second);
-	}
-	AKA_CRASH("Trying to get unattached component");
+	static_assert(std::is_base_of<Component<T, typename T::Archive>, T>::value, "Invalid type");
+	ComponentBase* component = findComponent(Component<T, typename T::Archive>::getComponentID());
+	AKA_ASSERT(component != nullptr, "Trying to get non attached component");
+	return *reinterpret_cast<T*>(component);
 }
 
 template<typename T>
 inline const T& Node::get() const
 {
-	static_assert(std::is_base_of<Component<T, T::Archive>, T>::value, "Invalid type");
-	const ComponentID componentID = Component<T, T::Archive>::getComponentID();
-	AKA_ASSERT(has<T>(), "Trying to get non attached component");
-	auto itActive = m_componentsActive.find(componentID);
-	if (itActive != m_componentsActive.end())
-	{
-		return *reinterpret_cast<T*>(itActive->second);
-	}
-	auto itToActivate = m_componentsToActivate.find(componentID);
-	if (itToActivate != m_componentsToActivate.end())
-	{
-		return *reinterpret_cast<T*>(itToActivate->second);
-	}
-	auto itToDeactivate = m_componentsToDeactivate.find(componentID);
-	if (itToDeactivate != m_componentsToDeactivate.end())
-	{
-		return *reinterpret_cast<T*>(itToDeactivate->second);
-	}
-	AKA_CRASH("Trying to get unattached component");
+	static_assert(std::is_base_of<Component<T, typename T::Archive>, T>::value, "Invalid type");
+	const ComponentBase* component = findComponent(Component<T, typename T::Archive>::getComponentID());
+	AKA_ASSERT(component != nullptr, "Trying to get non attached component");
+	return *reinterpret_cast<const T*>(component);
 }
+
 template<typename T>
-inline bool aka::Node::has() const
+inline bool Node::has() const
 {
-	static_assert(std::is_base_of<Component<T, T::Archive>, T>::value, "Invalid type");
-	const ComponentID componentID = Component<T, T::Archive>::getComponentID();
-	auto it = m_componentIDs.find(componentID);
-	return it != m_componentIDs.end();
+	static_assert(std::is_base_of<Component<T, typename T::Archive>, T>::value, "Invalid type");
+	return findComponent(Component<T, typename T::Archive>::getComponentID()) != nullptr;
 }
 
 template<typename T>
 inline void Node::setDirty()
 {
-	static_assert(std::is_base_of<Component<T, T::Archive>, T>::value, "Invalid type");
-	const ComponentID componentID = Component<T, T::Archive>::getComponentID();
-	AKA_ASSERT(has<T>(), "Trying to mark dirty non attached component");
-	auto itActive = m_componentsActive.find(componentID);
-	if (itActive != m_componentsActive.end())
-	{
-		return itActive->second->setDirty();
-	}
-	auto itToActivate = m_componentsToActivate.find(componentID);
-	if (itToActivate != m_componentsToActivate.end())
-	{
-		return itActive->second->setDirty();
-	}
-	AKA_CRASH("Trying to get unattached component");
+	static_assert(std::is_base_of<Component<T, typename T::Archive>, T>::value, "Invalid type");
+	ComponentBase* component = findComponent(Component<T, typename T::Archive>::getComponentID());
+	AKA_ASSERT(component != nullptr, "Trying to mark dirty non attached component");
+	component->setDirty();
 }
 
 }
\ No newline at end of file
@@ -1,8 +1,10 @@
 #pragma once
 
 #include <Aka/Core/Container/HashMap.hpp>
+#include <Aka/Scene/ChangeJournal.hpp>
 #include <Aka/Scene/ComponentAllocator.hpp>
 #include <Aka/Scene/Node.hpp>
+#include <Aka/Scene/TransformHierarchy.hpp>
 #include <Aka/Memory/Pool.h>
 #include <Aka/Core/Config.h>
 
@@ -25,22 +27,52 @@ public: // Components
 	ComponentBase* allocate(ComponentID _componentID, Node* _node);
 	// Deallocate component of any type
 	void deallocate(ComponentBase* component);
+	// Get the allocator of a component type, which index attached components by node
+	ComponentAllocatorBase& getComponentAllocator(ComponentID _componentID) { return *m_componentMap.get(_componentID); }
+	// Get the allocator of a component type, which index attached components by node
+	const ComponentAllocatorBase& getComponentAllocator(ComponentID _componentID) const { return *m_componentMap.get(_componentID); }
 
 public: // Nodes
 	// Allocate a node from pool
 	Node* create(const char* _name);
 	// Deallocate a node from pool
 	void destroy(Node* _node);
+	// Get a node from its handle, nullptr if node was destroyed
+	Node* get(NodeHandle _handle);
+	// Check if handle points to a living node
+	bool isValid(NodeHandle _handle) const;
+	// Get the current frame, used to track component changes
+	uint32_t getFrame() const { return m_frame; }
+	// Move to next frame & trim change journals
+	void nextFrame();
+	// Set the number of frames kept in change journals
+	void setChangeHistory(uint32_t _frameCount) { m_changeHistory = _frameCount; }
+	// Get the journal of nodes which world transform changed
+	ChangeJournal& getTransformJournal() { return m_transformJournal; }
+	// Get the journal of nodes which world transform changed
+	const ChangeJournal& getTransformJournal() const { return m_transformJournal; }
+	// Get the transforms of all nodes
+	TransformHierarchy& getTransforms() { return m_transforms; }
+	// Get the transforms of all nodes
+	const TransformHierarchy& getTransforms() const { return m_transforms; }
 public:
 	PoolIterator<Node> begin() { return m_nodePool.begin(); }
 	PoolIterator<Node> end() { return m_nodePool.end(); }
 	template <typename C> PoolRange<C> components();
 	void visitNodes(std::function<void(Node&)> _callback);
+	// Visit nodes which have all given components attached. Components should not be attached or detached while visiting.
+	void visitNodes(const ComponentID* _componentIDs, size_t _count, std::function<void(Node&)> _callback);
+	void visitComponentAllocators(std::function<void(ComponentAllocatorBase&)> _callback);
 	void visitComponentPools(std::function<void(ComponentBase&)> _callback);
 	void visitComponentPool(ComponentID _componentID, std::function<void(ComponentBase&)> _callback);
 private:
 	ComponentAllocatorMap m_componentMap;
+	TransformHierarchy m_transforms; // Before pool as nodes release their transform.
 	Pool<Node> m_nodePool;
+	SlotMap<Node*> m_nodeHandles; // Nodes stay in pool for stable addresses.
+	ChangeJournal m_transformJournal;
+	uint32_t m_frame;
+	uint32_t m_changeHistory; // Number of frames kept in journals
 };
 
 template <typename C> C* NodeAllocator::allocate(Node* _node) {
@@ -0,0 +1,230 @@
+#pragma once
+
+#include <tuple>
+#include <utility>
+
+#include <Aka/Core/Container/SmallVector.h>
+#include <Aka/Core/Worker/Parallel.h>
+#include <Aka/Scene/NodeAllocator.hpp>
+
+namespace aka {
+
+// Typed view over the nodes having all the given components, iterated as (node, components...) tuples.
+// Candidates are the nodes of the smallest component set, other components are checked in O(1).
+// Nodes can be filtered out with excluded components, or with components that did not change since a frame.
+// Components should not be attached or detached while iterating.
+template <typename... Components>
+class Query
+{
+	static_assert(sizeof...(Components) > 0, "Query needs at least one component.");
+public:
+	using Result = std::tuple<Node&, Components&...>;
+
+	class Iterator
+	{
+	public:
+		Iterator(const Query* _query, size_t _candidate, size_t _end);
+		Iterator& operator++();
+		Result operator*() const;
+		bool operator==(const Iterator& _iterator) const { return m_candidate == _iterator.m_candidate; }
+		bool operator!=(const Iterator& _iterator) const { return m_candidate != _iterator.m_candidate; }
+	private:
+		// Move to next matching candidate
+		void skip();
+	private:
+		const Query* m_query;
+		size_t m_candidate;
+		size_t m_end;
+	};
+	class Range
+	{
+	public:
+		Range(Iterator _begin, Iterator _end) : m_begin(_begin), m_end(_end) {}
+		Iterator begin() const { return m_begin; }
+		Iterator end() const { return m_end; }
+	private:
+		Iterator m_begin, m_end;
+	};
+public:
+	explicit Query(NodeAllocator& _allocator);
+
+	// Get a copy of this query skipping nodes which have this component attached.
+	// Returned by value so that it can be iterated from a temporary query.
+	template <typename C> Query exclude() const;
+	// Get a copy of this query skipping nodes which component did not change at given frame or after. Node without this component are skipped.
+	template <typename C> Query changedSince(uint32_t _frame) const;
+
+	Iterator begin() const;
+	Iterator end() const;
+
+	// Get the number of candidate nodes, before filtering
+	size_t getCandidateCount() const;
+	// Get the number of chunks of candidates
+	size_t getChunkCount(size_t _chunkSize) const;
+	// Get a chunk of candidates, chunks can be iterated from different threads.
+	Range getChunk(size_t _chunkIndex, size_t _chunkSize) const;
+
+	// Run func(node, components...) for every matching node
+	template <typename Func> void each(Func&& _func) const;
+	// Run func(node, components...) for every matching node, splitting candidates in chunks between workers.
+	template <typename Func> void each(WorkerPool& _pool, Func&& _func, size_t _chunkSize = 0) const;
+private:
+	// Check if a candidate pass all filters
+	bool match(size_t _candidate) const;
+	// Get the components of a candidate
+	template <size_t... Indices> Result get(size_t _candidate, std::index_sequence<Indices...>) const;
+	template <typename C> static ComponentID getID() { return Component<C, typename C::Archive>::getComponentID(); }
+private:
+	struct ChangedFilter
+	{
+		const ComponentAllocatorBase* components;
+		uint32_t frame;
+	};
+	static constexpr size_t ComponentCount = sizeof...(Components);
+	NodeAllocator* m_allocator;
+	const ComponentAllocatorBase* m_components[ComponentCount];
+	size_t m_candidates; // Index of the smallest set, which candidates are taken from
+	SmallVector<const ComponentAllocatorBase*, 2> m_excluded;
+	SmallVector<ChangedFilter, 2> m_changed;
+};
+
+template <typename... Components>
+Query<Components...>::Iterator::Iterator(const Query* _query, size_t _candidate, size_t _end) :
+	m_query(_query),
+	m_candidate(_candidate),
+	m_end(_end)
+{
+	skip();
+}
+template <typename... Components>
+typename Query<Components...>::Iterator& Query<Components...>::Iterator::operator++()
+{
+	m_candidate++;
+	skip();
+	return *this;
+}
+template <typename... Components>
+typename Query<Components...>::Result Query<Components...>::Iterator::operator*() const
+{
+	return m_query->get(m_candidate, std::index_sequence_for<Components...>{});
+}
+template <typename... Components>
+void Query<Components...>::Iterator::skip()
+{
+	while (m_candidate < m_end && !m_query->match(m_candidate))
+		m_candidate++;
+}
+
+template <typename... Components>
+Query<Components...>::Query(NodeAllocator& _allocator) :
+	m_allocator(&_allocator),
+	m_components{ &_allocator.getComponentAllocator(getID<Components>())... },
+	m_candidates(0)
+{
+	for (size_t i = 1; i < ComponentCount; i++)
+	{
+		if (m_components[i]->count() < m_components[m_candidates]->count())
+			m_candidates = i;
+	}
+}
+
+template <typename... Components>
+template <typename C>
+Query<Components...> Query<Components...>::exclude() const
+{
+	Query query(*this);
+	query.m_excluded.append(&m_allocator->getComponentAllocator(getID<C>()));
+	return query;
+}
+template <typename... Components>
+template <typename C>
+Query<Components...> Query<Components...>::changedSince(uint32_t _frame) const
+{
+	Query query(*this);
+	query.m_changed.append(ChangedFilter{ &m_allocator->getComponentAllocator(getID<C>()), _frame });
+	return query;
+}
+
+template <typename... Components>
+typename Query<Components...>::Iterator Query<Components...>::begin() const
+{
+	return Iterator(this, 0, getCandidateCount());
+}
+template <typename... Components>
+typename Query<Components...>::Iterator Query<Components...>::end() const
+{
+	return Iterator(this, getCandidateCount(), getCandidateCount());
+}
+
+template <typename... Components>
+size_t Query<Components...>::getCandidateCount() const
+{
+	return m_components[m_candidates]->count();
+}
+template <typename... Components>
+size_t Query<Components...>::getChunkCount(size_t _chunkSize) const
+{
+	AKA_ASSERT(_chunkSize > 0, "Invalid chunk size");
+	return (getCandidateCount() + _chunkSize - 1) / _chunkSize;
+}
+template <typename... Components>
+typename Query<Components...>::Range Query<Components...>::getChunk(size_t _chunkIndex, size_t _chunkSize) const
+{
+	const size_t count = getCandidateCount();
+	const size_t chunkBegin = min<size_t>(_chunkIndex * _chunkSize, count);
+	const size_t chunkEnd = min<size_t>(chunkBegin + _chunkSize, count);
+	return Range(Iterator(this, chunkBegin, chunkEnd), Iterator(this, chunkEnd, chunkEnd));
+}
+
+template <typename... Components>
+template <typename Func>
+void Query<Components...>::each(Func&& _func) const
+{
+	for (Result result : *this)
+		std::apply(_func, result);
+}
+template <typename... Components>
+template <typename Func>
+void Query<Components...>::each(WorkerPool& _pool, Func&& _func, size_t _chunkSize) const
+{
+	const size_t chunkSize = getParallelGrainSize(_pool, getCandidateCount(), _chunkSize);
+	parallelForChunk(_pool, getChunkCount(chunkSize), [&](size_t _chunkIndex) {
+		for (Result result : getChunk(_chunkIndex, chunkSize))
+			std::apply(_func, result);
+	});
+}
+
+template <typename... Components>
+bool Query<Components...>::match(size_t _candidate) const
+{
+	const uint32_t nodeIndex = m_components[m_candidates]->getNodes()[_candidate]->getHandle().index;
+	for (size_t i = 0; i < ComponentCount; i++)
+	{
+		if (i != m_candidates && m_components[i]->find(nodeIndex) == nullptr)
+			return false;
+	}
+	for (const ComponentAllocatorBase* excluded : m_excluded)
+	{
+		if (excluded->find(nodeIndex) != nullptr)
+			return false;
+	}
+	for (const ChangedFilter& changed : m_changed)
+	{
+		if (changed.components->find(nodeIndex) == nullptr || changed.components->getChangedFrame(nodeIndex) < changed.frame)
+			return false;
+	}
+	return true;
+}
+template <typename... Components>
+template <size_t... Indices>
+typename Query<Components...>::Result Query<Components...>::get(size_t _candidate, std::index_sequence<Indices...>) const
+{
+	Node* node = m_components[m_candidates]->getNodes()[_candidate];
+	const uint32_t nodeIndex = node->getHandle().index;
+	// Candidate set is read directly, others through their sparse index.
+	return Result(*node, *reinterpret_cast<Components*>(
+		Indices == m_candidates ? m_components[Indices]->getComponents()[_candidate] : m_components[Indices]->find(nodeIndex)
+	)...);
+}
+
+};
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <Aka/Core/Enum.h>
+#include <Aka/Core/Container/SmallVector.h>
+#include <Aka/Scene/ComponentType.hpp>
+
+namespace aka {
+
+template <typename T, typename A> struct Component;
+
+// Shared data accessed by component updates, which is not stored in components.
+enum class SystemResource : uint32_t
+{
+	None		= 0,
+
+	Transforms	= 1 << 0, // Node transforms & update flags
+	Renderer	= 1 << 1, // Renderer & asset library
+};
+AKA_IMPLEMENT_BITMASK_OPERATOR(SystemResource);
+
+// Data accessed by the updates of a component type, so that updates which do not conflict can run in parallel.
+// A component type declare it with a static SystemAccess getSystemAccess() function.
+// Types which do not declare it are exclusive & always run alone.
+struct SystemAccess
+{
+	SystemAccess();
+	// Access to everything, update run alone.
+	static SystemAccess all();
+
+	// Declare read access to another component type
+	template <typename T> SystemAccess& read() { return read(Component<T, typename T::Archive>::getComponentID()); }
+	// Declare write access to another component type
+	template <typename T> SystemAccess& write() { return write(Component<T, typename T::Archive>::getComponentID()); }
+	// Declare read access to another component type
+	SystemAccess& read(ComponentID _componentID);
+	// Declare write access to another component type
+	SystemAccess& write(ComponentID _componentID);
+	// Declare read access to shared resources
+	SystemAccess& read(SystemResource _resources);
+	// Declare write access to shared resources
+	SystemAccess& write(SystemResource _resources);
+	// Declare that components of this type can be updated in parallel, as each update only touch its own component & node.
+	SystemAccess& parallel();
+
+	// Check if two updates conflict & must run one after the other. Each update always write its own component type.
+	static bool conflicts(ComponentID _componentID, const SystemAccess& _access, ComponentID _otherComponentID, const SystemAccess& _otherAccess);
+
+	SmallVector<ComponentID, 4> reads;
+	SmallVector<ComponentID, 4> writes;
+	SystemResource readResources;
+	SystemResource writeResources;
+	bool exclusive; // Access unknown data
+	bool concurrent; // Components can be updated in parallel
+};
+
+};
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <Aka/Core/Enum.h>
+#include <Aka/Core/Container/Vector.h>
+#include <Aka/Scene/SystemAccess.hpp>
+
+namespace aka {
+
+class WorkerPool;
+class NodeAllocator;
+class ComponentBase;
+class ComponentAllocatorBase;
+
+enum class SystemPhase : uint8_t
+{
+	Update,
+	FixedUpdate,
+	RenderUpdate,
+
+	First = Update,
+	Last = RenderUpdate,
+};
+
+// Time spent in the updates of a component type during last run of each phase, in microseconds summed over all threads.
+struct SystemTiming
+{
+	const char* name;
+	ComponentID componentID;
+	uint32_t wave; // Systems of a wave run together
+	uint64_t time[EnumCount<SystemPhase>()];
+};
+
+// Run the updates of each component type as a system, based on their declared SystemAccess.
+// Systems are ordered by name & grouped in waves of systems that do not conflict with each other.
+// Waves run one after the other, & systems of a wave run in parallel, split in chunks when concurrent.
+// As conflicting systems always run in the same order, results do not depend on scheduling.
+// Components can only be attached or detached by updates of exclusive systems.
+class SystemScheduler
+{
+public:
+	using UpdateFunc = void(*)(ComponentBase& _component, void* _userData);
+
+	SystemScheduler();
+	SystemScheduler(const SystemScheduler&) = delete;
+	SystemScheduler& operator=(const SystemScheduler&) = delete;
+	~SystemScheduler();
+
+	// Build systems for every component type of the allocator.
+	void build(NodeAllocator& _allocator);
+	// Run func(component, userData) for every active component. Run on calling thread if there is no pool.
+	void run(SystemPhase _phase, WorkerPool* _pool, UpdateFunc _func, void* _userData);
+	// Run func(component) for every active component. Run on calling thread if there is no pool.
+	template <typename Func> void run(SystemPhase _phase, WorkerPool* _pool, Func&& _func);
+
+	// Get the number of systems
+	size_t getSystemCount() const { return m_systems.size(); }
+	// Get the number of waves
+	size_t getWaveCount() const { return m_waves.size() > 0 ? m_waves.size() - 1 : 0; }
+	// Get the timing of a system
+	const SystemTiming& getTiming(size_t _index) const { return m_systems[_index].timing; }
+private:
+	struct System
+	{
+		ComponentAllocatorBase* components;
+		SystemAccess access;
+		SystemTiming timing;
+		Vector<ComponentBase*, AllocatorCategory::Component> snapshot; // Components iterated by exclusive systems
+	};
+	// Range of components of a system run by a single job
+	struct Task
+	{
+		System* system;
+		size_t begin;
+		size_t end;
+		uint64_t time;
+	};
+	static void execute(Task& _task, UpdateFunc _func, void* _userData);
+private:
+	Vector<System> m_systems; // Sorted by wave, then by name.
+	Vector<uint32_t> m_waves; // First system of each wave, followed by the system count
+	Vector<Task> m_tasks;
+};
+
+template <typename Func>
+void SystemScheduler::run(SystemPhase _phase, WorkerPool* _pool, Func&& _func)
+{
+	run(_phase, _pool, [](ComponentBase& _component, void* _userData) {
+		(*static_cast<typename std::remove_reference<Func>::type*>(_userData))(_component);
+	}, const_cast<void*>(static_cast<const void*>(&_func)));
+}
+
+};
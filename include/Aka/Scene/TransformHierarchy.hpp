@@ -0,0 +1,90 @@
+#pragma once
+
+#include <Aka/Core/Config.h>
+#include <Aka/Core/Geometry.h>
+#include <Aka/Core/Container/Vector.h>
+
+namespace aka {
+
+class WorkerPool;
+
+// Stable ID of a transform in a hierarchy, even when transforms are reordered.
+enum class TransformID : uint32_t { Invalid = ~0U };
+
+// Flat storage of the transforms of a node hierarchy.
+// Local & world matrices are stored in contiguous arrays sorted by depth, so that a parent is always before its childs.
+// World matrices are propagated from dirty transforms in a single linear pass, where each depth level can be split in jobs.
+class TransformHierarchy
+{
+public:
+	TransformHierarchy();
+	TransformHierarchy(const TransformHierarchy&) = delete;
+	TransformHierarchy& operator=(const TransformHierarchy&) = delete;
+	~TransformHierarchy();
+
+	// Create a root transform with an identity matrix
+	TransformID create();
+	// Destroy a transform. Its childs should be destroyed or reparented before.
+	void destroy(TransformID id);
+	// Set the parent of a transform, Invalid to make it a root.
+	void setParent(TransformID id, TransformID parent);
+
+	// Set the local matrix of a transform & mark it dirty.
+	void setLocal(TransformID id, const mat4f& transform);
+	// Mark the world matrix of a transform dirty, when one of its parents is.
+	void setDirty(TransformID id);
+	// Get the local matrix of a transform
+	const mat4f& getLocal(TransformID id) const;
+	// Get the world matrix of a transform, as of last propagation.
+	const mat4f& getWorld(TransformID id) const;
+	// Check if the world matrix of a transform is waiting for a propagation
+	bool isDirty(TransformID id) const;
+	// Check if the world matrix of a transform changed since last call to clearUpdated
+	bool isUpdated(TransformID id) const;
+
+	// Compute the world matrix of a transform right away, after its dirty parents.
+	// Its childs are only refreshed by next propagation.
+	void computeWorld(TransformID id);
+	// Propagate world matrices of dirty transforms & their childs.
+	void update();
+	// Propagate world matrices of dirty transforms & their childs, splitting big depth levels between workers.
+	void update(WorkerPool& pool);
+	// Clear updated flags, once every transform update was consumed.
+	void clearUpdated();
+
+	// Get the number of transforms
+	size_t size() const;
+	// Get the number of depth levels
+	size_t getDepthCount() const;
+private:
+	enum Flag : uint8_t
+	{
+		Dirty = 1 << 0, // World matrix need to be recomputed
+		Updated = 1 << 1, // World matrix changed, childs need to be recomputed
+		Removed = 1 << 2, // Transform is destroyed & will be removed on next sort
+	};
+	static constexpr uint32_t InvalidIndex = ~0U;
+	// Reorder transforms by depth & remove destroyed ones
+	void sort();
+	// Compute the world matrix of a single transform from its parent world matrix
+	void compute(uint32_t index);
+	// Compute the world matrix of a single transform if it or its parent changed
+	void propagate(uint32_t index);
+	uint32_t getIndex(TransformID id) const;
+private:
+	// Sorted by depth, indexed by transform index.
+	Vector<mat4f> m_locals;
+	Vector<mat4f> m_worlds;
+	Vector<uint32_t> m_parents; // Index of the parent, InvalidIndex for roots
+	Vector<uint8_t> m_flags;
+	Vector<TransformID> m_ids; // ID of each index
+	Vector<uint32_t> m_levels; // First index of each depth level, followed by the transform count
+
+	// Indexed by ID.
+	Vector<uint32_t> m_indices; // Index of each ID
+	Vector<TransformID> m_freeIDs;
+
+	bool m_orderDirty; // Transforms are not sorted by depth anymore
+};
+
+};
@@ -136,12 +136,15 @@ void RtAudioDevice::process(AudioFrame* buffer, uint32_t frames)
 	Vector<AudioFrame> tmp(frames * m_channelCount);
 	for (auto it = m_streams.begin(); it != m_streams.end();)
 	{
-		HashSet<AudioStream*>::iterator current = it++;
-		AudioStream* stream = (*current);
-		if (!stream->decode(tmp.data(), frames * m_channelCount))
-			m_streams.erase(current);
+		AudioStream* stream = (*it);
+		const bool playing = stream->decode(tmp.data(), frames * m_channelCount);
 		for (unsigned int i = 0; i < frames * m_channelCount; i++)
 			buffer[i] = mix(buffer[i], static_cast<AudioFrame>(tmp[i] * stream->volume()));
+		// Erase move the last stream at this position, so do not increment.
+		if (playing)
+			it++;
+		else
+			it = m_streams.erase(it);
 	}
 }
 
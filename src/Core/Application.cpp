@@ -6,6 +6,7 @@
 #include <Aka/Audio/AudioDevice.h>
 #include <Aka/OS/OS.h>
 #include <Aka/OS/Logger.h>
+#include <Aka/Memory/Memory.h>
 #include <Aka/Renderer/Renderer.hpp>
 #include <Aka/Scene/Component/StaticMeshComponent.hpp>
 #include <Aka/Scene/Component/SkeletalMeshComponent.hpp>
@@ -266,6 +267,8 @@ void Application::run(Application* app)
 
 		app->end();
 		EventDispatcher<QuitEvent>::dispatch();
+		// Scratch memory of this frame is not used anymore.
+		mem::resetFrameAllocators();
 	} while (app->m_running);
 	app->destroy();
 }
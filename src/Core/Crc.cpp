@@ -0,0 +1,70 @@
+#include <Aka/Core/Crc.hpp>
+
+#if defined(__ARM_FEATURE_CRC32)
+#include <arm_acle.h>
+#define AKA_CRC32_ARM 1
+#elif defined(_MSC_VER) && defined(_M_ARM64)
+#include <intrin.h>
+#define AKA_CRC32_ARM 1
+#endif
+
+namespace aka {
+
+#if !defined(AKA_CRC32_ARM)
+// Tables for slicing by 8, table k giving the crc of a byte followed by k zero bytes.
+struct CrcSlicingTables
+{
+	uint32_t table[8][256];
+};
+
+static constexpr CrcSlicingTables generateSlicingTables()
+{
+	CrcSlicingTables tables{};
+	for (uint32_t i = 0; i < 256; i++)
+		tables.table[0][i] = crc_table[i];
+	for (uint32_t i = 0; i < 256; i++)
+		for (uint32_t k = 1; k < 8; k++)
+			tables.table[k][i] = (tables.table[k - 1][i] >> 8) ^ crc_table[tables.table[k - 1][i] & 0xFF];
+	return tables;
+}
+
+static constexpr CrcSlicingTables s_slicingTables = generateSlicingTables();
+#endif
+
+uint32_t crc32_runtime(const void* data, size_t length, uint32_t crc)
+{
+	const uint8_t* p = static_cast<const uint8_t*>(data);
+	crc = ~crc;
+#if defined(AKA_CRC32_ARM)
+	for (; length >= 8; length -= 8, p += 8)
+	{
+		uint64_t value;
+		memcpy(&value, p, sizeof(uint64_t));
+		crc = __crc32d(crc, value);
+	}
+	for (; length > 0; length--, p++)
+		crc = __crc32b(crc, *p);
+#else
+	const auto& t = s_slicingTables.table;
+	// Reads assume a little endian platform, as all supported ones are.
+	for (; length >= 8; length -= 8, p += 8)
+	{
+		uint32_t low, high;
+		memcpy(&low, p, sizeof(uint32_t));
+		memcpy(&high, p + 4, sizeof(uint32_t));
+		low ^= crc;
+		crc = t[7][low & 0xFF] ^ t[6][(low >> 8) & 0xFF] ^ t[5][(low >> 16) & 0xFF] ^ t[4][low >> 24] ^
+			t[3][high & 0xFF] ^ t[2][(high >> 8) & 0xFF] ^ t[1][(high >> 16) & 0xFF] ^ t[0][high >> 24];
+	}
+	for (; length > 0; length--, p++)
+		crc = (crc >> 8) ^ crc_table[(crc & 0xFF) ^ *p];
+#endif
+	return ~crc;
+}
+
+uint32_t WSID_runtime(const char* str)
+{
+	return crc32_runtime(str, strlen(str));
+}
+
+}
@@ -2,6 +2,13 @@
 
 #include <Aka/Platform/Platform.h>
 
+#include <cstring>
+#include <algorithm>
+
+#if defined(_MSC_VER) && defined(_M_X64)
+#include <intrin.h>
+#endif
+
 namespace aka {
 
 namespace hash {
@@ -30,5 +37,166 @@ std::size_t fnv(const void* data, std::size_t size)
 	return s;
 }
 
+// Runtime wyhash helpers, using native 128 bits multiply when available.
+static inline void wymum(uint64_t& a, uint64_t& b)
+{
+#if defined(__SIZEOF_INT128__)
+	__uint128_t r = a;
+	r *= b;
+	a = static_cast<uint64_t>(r);
+	b = static_cast<uint64_t>(r >> 64);
+#elif defined(_MSC_VER) && defined(_M_X64)
+	a = _umul128(a, b, &b);
+#else
+	detail::wymum_c(a, b);
+#endif
+}
+static inline uint64_t wymix(uint64_t a, uint64_t b)
+{
+	wymum(a, b);
+	return a ^ b;
+}
+// Reads assume a little endian platform, as all supported ones are.
+static inline uint64_t wyr8(const uint8_t* p)
+{
+	uint64_t v;
+	memcpy(&v, p, sizeof(uint64_t));
+	return v;
+}
+static inline uint64_t wyr4(const uint8_t* p)
+{
+	uint32_t v;
+	memcpy(&v, p, sizeof(uint32_t));
+	return v;
+}
+static inline uint64_t wyr3(const uint8_t* p, size_t k)
+{
+	return (static_cast<uint64_t>(p[0]) << 16) | (static_cast<uint64_t>(p[k >> 1]) << 8) | p[k - 1];
+}
+static inline uint64_t wyseed(uint64_t seed)
+{
+	return seed ^ wymix(seed ^ detail::WyhashSecret[0], detail::WyhashSecret[1]);
+}
+// Process a block of 48 bytes in three lanes
+static inline void wyblock(const uint8_t* p, uint64_t& seed, uint64_t& see1, uint64_t& see2)
+{
+	seed = wymix(wyr8(p) ^ detail::WyhashSecret[1], wyr8(p + 8) ^ seed);
+	see1 = wymix(wyr8(p + 16) ^ detail::WyhashSecret[2], wyr8(p + 24) ^ see1);
+	see2 = wymix(wyr8(p + 32) ^ detail::WyhashSecret[3], wyr8(p + 40) ^ see2);
+}
+// Hash the last 48 bytes or less, with 16 readable bytes before p if more than 16 bytes were hashed.
+static inline uint64_t wyfinalize(const uint8_t* p, size_t i, size_t size, uint64_t seed)
+{
+	uint64_t a = 0, b = 0;
+	if (size <= 16)
+	{
+		if (size >= 4)
+		{
+			a = (wyr4(p) << 32) | wyr4(p + ((size >> 3) << 2));
+			b = (wyr4(p + size - 4) << 32) | wyr4(p + size - 4 - ((size >> 3) << 2));
+		}
+		else if (size > 0)
+		{
+			a = wyr3(p, size);
+		}
+	}
+	else
+	{
+		while (i > 16)
+		{
+			seed = wymix(wyr8(p) ^ detail::WyhashSecret[1], wyr8(p + 8) ^ seed);
+			i -= 16;
+			p += 16;
+		}
+		a = wyr8(p + i - 16);
+		b = wyr8(p + i - 8);
+	}
+	a ^= detail::WyhashSecret[1];
+	b ^= seed;
+	wymum(a, b);
+	return wymix(a ^ detail::WyhashSecret[0] ^ size, b ^ detail::WyhashSecret[1]);
+}
+
+uint64_t wyhash(const void* data, size_t size, uint64_t seed)
+{
+	const uint8_t* p = static_cast<const uint8_t*>(data);
+	seed = wyseed(seed);
+	size_t i = size;
+	if (i > 48)
+	{
+		uint64_t see1 = seed, see2 = seed;
+		do
+		{
+			wyblock(p, seed, see1, see2);
+			p += 48;
+			i -= 48;
+		} while (i > 48);
+		seed ^= see1 ^ see2;
+	}
+	return wyfinalize(p, i, size, seed);
+}
+
+WyhashState::WyhashState(uint64_t seed) :
+	m_seed(seed),
+	m_state{ 0, 0, 0 },
+	m_length(0),
+	m_pendingSize(0),
+	m_buffer{}
+{
+	m_state[0] = m_state[1] = m_state[2] = wyseed(seed);
+}
+
+void WyhashState::update(const void* data, size_t size)
+{
+	const uint8_t* p = static_cast<const uint8_t*>(data);
+	m_length += size;
+	while (size > 0)
+	{
+		// A full block is only processed once we know more data follows, as wyhash keep the last one for finalization.
+		if (m_pendingSize == BlockSize)
+		{
+			wyblock(m_buffer + HistorySize, m_state[0], m_state[1], m_state[2]);
+			memcpy(m_buffer, m_buffer + HistorySize + BlockSize - HistorySize, HistorySize);
+			m_pendingSize = 0;
+		}
+		if (m_pendingSize == 0 && size > BlockSize)
+		{
+			// Process blocks directly from data while more data follows them.
+			do
+			{
+				wyblock(p, m_state[0], m_state[1], m_state[2]);
+				p += BlockSize;
+				size -= BlockSize;
+			} while (size > BlockSize);
+			memcpy(m_buffer, p - HistorySize, HistorySize);
+		}
+		const size_t count = std::min(size, BlockSize - m_pendingSize);
+		memcpy(m_buffer + HistorySize + m_pendingSize, p, count);
+		m_pendingSize += count;
+		p += count;
+		size -= count;
+	}
+}
+
+uint64_t WyhashState::digest() const
+{
+	if (m_length <= BlockSize)
+		return wyhash(m_buffer + HistorySize, m_length, m_seed);
+	// Some blocks were processed.
+	const uint64_t seed = m_state[0] ^ m_state[1] ^ m_state[2];
+	return wyfinalize(m_buffer + HistorySize, m_pendingSize, m_length, seed);
+}
+
+size_t buffer(const void* data, size_t size, size_t seed)
+{
+#if defined(AKA_HASH_BACKEND_FNV)
+	size_t s = FNV_offsetBasis ^ seed;
+	fnv(s, data, size);
+	return s;
+#else
+	return static_cast<size_t>(wyhash(data, size, seed));
+#endif
+}
+
 }; // namespace hash
-}; // namespace aka
\ No newline at end of file
+}; // namespace aka
@@ -0,0 +1,159 @@
+#include <Aka/Core/StringTable.hpp>
+
+#include <mutex>
+
+namespace aka {
+
+bool StringTable::Key::operator==(const Key& key) const
+{
+	return length == key.length && Memory::compare(string, key.string, length) == 0;
+}
+
+size_t StringTable::KeyHasher::operator()(const Key& key) const
+{
+	return hash::buffer(key.string, key.length);
+}
+
+StringTable::StringTable() :
+	m_ids(),
+	m_pages{},
+	m_count(0),
+	m_blocks(),
+	m_block(nullptr),
+	m_blockOffset(0),
+	m_usedMemory(0)
+{
+	// Empty string is always interned first so that its ID is zero.
+	const StringID empty = intern("", 0);
+	AKA_UNUSED(empty);
+	AKA_ASSERT(empty == StringID::Empty, "Invalid empty string ID");
+}
+
+StringTable::~StringTable()
+{
+	Allocator& allocator = mem::getAllocator(AllocatorMemoryType::String, AllocatorCategory::Global);
+	for (char* block : m_blocks)
+		allocator.deallocate(block);
+	for (std::atomic<Entry*>& page : m_pages)
+		allocator.deallocate(page.load(std::memory_order_relaxed));
+}
+
+StringID StringTable::intern(const char* string)
+{
+	return intern(string, String::length(string));
+}
+
+StringID StringTable::intern(const String& string)
+{
+	return intern(string.cstr(), string.length());
+}
+
+StringID StringTable::intern(const char* string, size_t length)
+{
+	StringID id;
+	if (find(string, length, id))
+		return id;
+	std::unique_lock<std::shared_mutex> lock(m_mutex);
+	// Another thread might have interned it while lock was released.
+	auto it = m_ids.find(Key{ string, length });
+	if (it != m_ids.end())
+		return it->second;
+	const uint32_t index = m_count.load(std::memory_order_relaxed);
+	const size_t pageIndex = index / PageSize;
+	AKA_ASSERT(pageIndex < PageCount, "Too many interned strings");
+	Entry* page = m_pages[pageIndex].load(std::memory_order_relaxed);
+	if (page == nullptr)
+	{
+		page = mem::getAllocator(AllocatorMemoryType::String, AllocatorCategory::Global).allocate<Entry>(PageSize);
+		m_pages[pageIndex].store(page, std::memory_order_release);
+	}
+	const char* stored = store(string, length);
+	page[index % PageSize] = Entry{ stored, length };
+	id = static_cast<StringID>(index);
+	m_ids.insert(std::make_pair(Key{ stored, length }, id));
+	m_count.store(index + 1, std::memory_order_release);
+	return id;
+}
+
+bool StringTable::find(const char* string, size_t length, StringID& id) const
+{
+	std::shared_lock<std::shared_mutex> lock(m_mutex);
+	auto it = m_ids.find(Key{ string, length });
+	if (it == m_ids.end())
+		return false;
+	id = it->second;
+	return true;
+}
+
+const char* StringTable::getString(StringID id) const
+{
+	return getEntry(id).string;
+}
+
+size_t StringTable::getLength(StringID id) const
+{
+	return getEntry(id).length;
+}
+
+size_t StringTable::size() const
+{
+	return m_count.load(std::memory_order_acquire);
+}
+
+size_t StringTable::getUsedMemory() const
+{
+	std::shared_lock<std::shared_mutex> lock(m_mutex);
+	return m_usedMemory;
+}
+
+const char* StringTable::store(const char* string, size_t length)
+{
+	Allocator& allocator = mem::getAllocator(AllocatorMemoryType::String, AllocatorCategory::Global);
+	const size_t size = length + 1;
+	char* stored = nullptr;
+	if (size > BlockSize / 4)
+	{
+		// Big strings get their own allocation to avoid wasting blocks.
+		stored = allocator.allocate<char>(size);
+		m_blocks.append(stored);
+		m_usedMemory += size;
+	}
+	else
+	{
+		if (m_block == nullptr || m_blockOffset + size > BlockSize)
+		{
+			m_block = allocator.allocate<char>(BlockSize);
+			m_blocks.append(m_block);
+			m_blockOffset = 0;
+			m_usedMemory += BlockSize;
+		}
+		stored = m_block + m_blockOffset;
+		m_blockOffset += size;
+	}
+	Memory::copy(stored, string, length);
+	stored[length] = '\0';
+	return stored;
+}
+
+const StringTable::Entry& StringTable::getEntry(StringID id) const
+{
+	const uint32_t index = static_cast<uint32_t>(id);
+	AKA_ASSERT(index < m_count.load(std::memory_order_acquire), "Invalid string ID");
+	const Entry* page = m_pages[index / PageSize].load(std::memory_order_acquire);
+	return page[index % PageSize];
+}
+
+StringTable& getStringTable()
+{
+	// Allocators must outlive the table.
+	static Allocator& stringAllocator = mem::getAllocator(AllocatorMemoryType::String, AllocatorCategory::Global);
+	static Allocator& vectorAllocator = mem::getAllocator(AllocatorMemoryType::Vector, AllocatorCategory::Global);
+	static Allocator& mapAllocator = mem::getAllocator(AllocatorMemoryType::Map, AllocatorCategory::Global);
+	AKA_UNUSED(stringAllocator);
+	AKA_UNUSED(vectorAllocator);
+	AKA_UNUSED(mapAllocator);
+	static StringTable table;
+	return table;
+}
+
+};
@@ -2,6 +2,74 @@
 
 namespace aka {
 
+JobCounter::JobCounter() :
+	m_count(0)
+{
+}
+
+JobCounter::~JobCounter()
+{
+	AKA_ASSERT(isFinished(), "Destroying counter of running jobs");
+}
+
+uint32_t JobCounter::get() const
+{
+	return m_count.load(std::memory_order_acquire);
+}
+
+bool JobCounter::isFinished() const
+{
+	return get() == 0;
+}
+
+CancellationToken::CancellationToken() :
+	m_cancelled(false)
+{
+}
+
+CancellationToken::~CancellationToken()
+{
+}
+
+void CancellationToken::cancel()
+{
+	m_cancelled.store(true, std::memory_order_release);
+}
+
+void CancellationToken::reset()
+{
+	m_cancelled.store(false, std::memory_order_release);
+}
+
+bool CancellationToken::isCancelled() const
+{
+	return m_cancelled.load(std::memory_order_acquire);
+}
+
+Job::Job() :
+	m_token(nullptr),
+	m_parent(nullptr),
+	m_counter(nullptr),
+	m_unfinishedJobs(1),
+	m_pendingDependencies(1),
+	m_continuationCount(0),
+	m_continuations{},
+	m_priority(JobPriority::Normal),
+	m_io(false),
+	m_queuedTime(0)
+{
+}
+
+void Job::setCancellationToken(const CancellationToken* token)
+{
+	m_token = token;
+}
+
+bool Job::isCancelled() const
+{
+	return m_token != nullptr && m_token->isCancelled();
+}
+
 TrackedJob::TrackedJob() :
 	m_status(JobStatus::Waiting)
 {
@@ -34,14 +102,14 @@ void TrackedJob::operator()()
 	m_status = JobStatus::Finished;
 }
 
-LambdaJob::LambdaJob(std::function<void(void)>&& lambda) :
-	m_job(std::move(lambda))
+LambdaJob::~LambdaJob()
 {
+	m_destroy(m_storage);
 }
 
 void LambdaJob::execute()
 {
-	m_job();
+	m_invoke(m_storage);
 }
 
 };
\ No newline at end of file
@@ -0,0 +1,146 @@
+#include <Aka/Core/Worker/JobAllocator.h>
+
+#include <Aka/Memory/Memory.h>
+#include <Aka/Memory/ThreadLocalRegistry.h>
+#include <Aka/Core/Container/Vector.h>
+
+#include <atomic>
+
+namespace aka {
+
+// Header stored at the beginning of each record.
+struct JobRecord
+{
+	JobRecordCache* owner; // Cache the record belong to. nullptr if allocated outside of a cache.
+	JobRecord* next; // Next free record when in a free list.
+};
+static_assert(sizeof(JobRecord) <= JobAllocator::recordAlignment, "Header too big");
+static_assert(JobAllocator::recordSize % JobAllocator::recordAlignment == 0, "Record size must be a multiple of alignment");
+
+static Allocator& getJobRecordAllocator()
+{
+	return mem::getAllocator(AllocatorMemoryType::Object, AllocatorCategory::Global);
+}
+
+class JobRecordCache
+{
+public:
+	static const size_t recordCountPerChunk = 64;
+public:
+	JobRecordCache() :
+		m_freeList(nullptr),
+		m_remoteFreeList(nullptr),
+		m_chunks()
+	{
+	}
+	~JobRecordCache()
+	{
+		for (uint8_t* chunk : m_chunks)
+			getJobRecordAllocator().alignedDeallocate(chunk);
+	}
+	// Acquire a record. Owner thread only.
+	JobRecord* acquire()
+	{
+		if (m_freeList == nullptr)
+		{
+			// Take back all records freed by other threads.
+			m_freeList = m_remoteFreeList.exchange(nullptr, std::memory_order_acquire);
+			if (m_freeList == nullptr)
+				grow();
+		}
+		JobRecord* record = m_freeList;
+		m_freeList = record->next;
+		record->owner = this;
+		record->next = nullptr;
+		return record;
+	}
+	// Release a record from the owner thread.
+	void release(JobRecord* record)
+	{
+		record->next = m_freeList;
+		m_freeList = record;
+	}
+	// Release a record from any other thread.
+	void releaseRemote(JobRecord* record)
+	{
+		JobRecord* head = m_remoteFreeList.load(std::memory_order_relaxed);
+		do {
+			record->next = head;
+		} while (!m_remoteFreeList.compare_exchange_weak(head, record, std::memory_order_release, std::memory_order_relaxed));
+	}
+private:
+	// Allocate a new chunk of records & add them to the free list.
+	void grow()
+	{
+		uint8_t* chunk = getJobRecordAllocator().alignedAllocate<uint8_t>(recordCountPerChunk * JobAllocator::recordSize, JobAllocator::recordAlignment);
+		m_chunks.append(chunk);
+		for (size_t iRecord = 0; iRecord < recordCountPerChunk; iRecord++)
+		{
+			JobRecord* record = reinterpret_cast<JobRecord*>(chunk + iRecord * JobAllocator::recordSize);
+			record->owner = this;
+			record->next = m_freeList;
+			m_freeList = record;
+		}
+	}
+private:
+	JobRecord* m_freeList; // Records owned by this cache.
+	std::atomic<JobRecord*> m_remoteFreeList; // Records released by other threads.
+	Vector<uint8_t*> m_chunks;
+};
+
+// Keep track of all caches so that records outlive the thread that allocated them.
+static ThreadLocalRegistry<JobRecordCache>& getJobRecordCacheRegistry()
+{
+	// Ensure the allocator outlives the registry as it is used in its destructor.
+	getJobRecordAllocator();
+	static ThreadLocalRegistry<JobRecordCache> s_registry(
+		[]() { return mem::akaNew<JobRecordCache>(AllocatorMemoryType::Object, AllocatorCategory::Global); },
+		[](JobRecordCache* cache) { mem::akaDelete(cache); }
+	);
+	return s_registry;
+}
+
+static thread_local JobRecordCache* s_currentCache = nullptr;
+
+static JobRecordCache* getCurrentJobRecordCache()
+{
+	if (s_currentCache == nullptr)
+	{
+		static thread_local ThreadLocalRegistryEntry<JobRecordCache> s_threadCache(getJobRecordCacheRegistry());
+		s_currentCache = s_threadCache.get();
+	}
+	return s_currentCache;
+}
+
+void* JobAllocator::allocate(size_t size)
+{
+	JobRecord* record = nullptr;
+	if (size <= maxJobSize)
+	{
+		record = getCurrentJobRecordCache()->acquire();
+	}
+	else
+	{
+		// Too big for a record, fallback to the object allocator.
+		record = reinterpret_cast<JobRecord*>(getJobRecordAllocator().alignedAllocate<uint8_t>(recordAlignment + size, recordAlignment));
+		record->owner = nullptr;
+		record->next = nullptr;
+	}
+	return reinterpret_cast<uint8_t*>(record) + recordAlignment;
+}
+
+void JobAllocator::deallocate(void* data)
+{
+	if (data == nullptr)
+		return;
+	JobRecord* record = reinterpret_cast<JobRecord*>(static_cast<uint8_t*>(data) - recordAlignment);
+	JobRecordCache* owner = record->owner;
+	if (owner == nullptr)
+		getJobRecordAllocator().alignedDeallocate(record);
+	else if (owner == s_currentCache)
+		owner->release(record);
+	else
+		owner->releaseRemote(record);
+}
+
+};
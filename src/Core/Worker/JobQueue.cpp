@@ -0,0 +1,137 @@
+#include <Aka/Core/Worker/JobQueue.h>
+
+namespace aka {
+
+JobQueue::JobQueue() :
+	m_top(0),
+	m_bottom(0)
+{
+	for (std::atomic<Job*>& job : m_jobs)
+		job.store(nullptr, std::memory_order_relaxed);
+}
+
+JobQueue::~JobQueue()
+{
+}
+
+bool JobQueue::push(Job* job)
+{
+	const int64_t bottom = m_bottom.load(std::memory_order_relaxed);
+	const int64_t top = m_top.load(std::memory_order_acquire);
+	if (bottom - top >= capacity)
+		return false; // Full
+	m_jobs[bottom & (capacity - 1)].store(job, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+	m_bottom.store(bottom + 1, std::memory_order_relaxed);
+	return true;
+}
+
+Job* JobQueue::pop()
+{
+	const int64_t bottom = m_bottom.load(std::memory_order_relaxed) - 1;
+	m_bottom.store(bottom, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	int64_t top = m_top.load(std::memory_order_relaxed);
+	if (top > bottom)
+	{
+		// Empty, restore bottom.
+		m_bottom.store(bottom + 1, std::memory_order_relaxed);
+		return nullptr;
+	}
+	Job* job = m_jobs[bottom & (capacity - 1)].load(std::memory_order_relaxed);
+	if (top == bottom)
+	{
+		// Last job, race against thieves.
+		if (!m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+			job = nullptr; // Stolen
+		m_bottom.store(bottom + 1, std::memory_order_relaxed);
+	}
+	return job;
+}
+
+Job* JobQueue::steal()
+{
+	int64_t top = m_top.load(std::memory_order_acquire);
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	const int64_t bottom = m_bottom.load(std::memory_order_acquire);
+	if (top >= bottom)
+		return nullptr; // Empty
+	Job* job = m_jobs[top & (capacity - 1)].load(std::memory_order_relaxed);
+	if (!m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+		return nullptr; // Lost the race with another thief or the owner.
+	return job;
+}
+
+size_t JobQueue::size() const
+{
+	const int64_t bottom = m_bottom.load(std::memory_order_relaxed);
+	const int64_t top = m_top.load(std::memory_order_relaxed);
+	return bottom > top ? static_cast<size_t>(bottom - top) : 0;
+}
+
+bool JobQueue::empty() const
+{
+	return size() == 0;
+}
+
+SharedJobQueue::SharedJobQueue() :
+	m_queue(),
+	m_count(0),
+	m_jobs(64, nullptr),
+	m_offset(0)
+{
+}
+
+SharedJobQueue::~SharedJobQueue()
+{
+}
+
+void SharedJobQueue::push(Job* job)
+{
+	// Keep using overflow while it is not empty, so that older jobs are not overtaken for long.
+	if (m_count.load() == 0 && m_queue.push(job))
+		return;
+	std::lock_guard<std::mutex> lock(m_mutex);
+	const size_t count = m_count.load();
+	const size_t capacity = m_jobs.size();
+	if (count == capacity)
+	{
+		// Full, unroll the ring buffer into a bigger one.
+		Vector<Job*> jobs(capacity * 2, nullptr);
+		for (size_t iJob = 0; iJob < count; iJob++)
+			jobs[iJob] = m_jobs[(m_offset + iJob) % capacity];
+		m_jobs = std::move(jobs);
+		m_offset = 0;
+	}
+	m_jobs[(m_offset + count) % m_jobs.size()] = job;
+	m_count.store(count + 1);
+}
+
+Job* SharedJobQueue::pop()
+{
+	Job* queuedJob = nullptr;
+	if (m_queue.pop(queuedJob))
+		return queuedJob;
+	if (m_count.load() == 0)
+		return nullptr;
+	std::lock_guard<std::mutex> lock(m_mutex);
+	const size_t count = m_count.load();
+	if (count == 0)
+		return nullptr;
+	Job* job = m_jobs[m_offset];
+	m_offset = (m_offset + 1) % m_jobs.size();
+	m_count.store(count - 1);
+	return job;
+}
+
+size_t SharedJobQueue::size() const
+{
+	return m_queue.size() + m_count.load();
+}
+
+bool SharedJobQueue::empty() const
+{
+	return size() == 0;
+}
+
+};
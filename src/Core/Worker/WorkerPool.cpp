@@ -3,18 +3,81 @@
 #include <Aka/Core/Worker/Job.h>
 
 #include <thread>
+#include <chrono>
 #include <functional>
 
 namespace aka {
 
+// Pool & worker index of the current thread, if it is a worker.
+static thread_local WorkerPool* s_currentPool = nullptr;
+static thread_local uint32_t s_currentWorkerIndex = ~0U;
+static thread_local bool s_currentIOWorker = false;
+
+// Get current time in microseconds
+static uint64_t getJobTime()
+{
+	using namespace std::chrono;
+	return static_cast<uint64_t>(duration_cast<microseconds>(steady_clock::now().time_since_epoch()).count());
+}
+
+WorkerPool::Stats::Stats() :
+	queuedJobs(0),
+	executedJobs(0),
+	totalWaitTime(0),
+	maxWaitTime(0)
+{
+}
+
+void WorkerPool::Stats::push(Job* job)
+{
+	job->m_queuedTime = getJobTime();
+	queuedJobs.fetch_add(1, std::memory_order_relaxed);
+}
+
+void WorkerPool::Stats::pop(Job* job)
+{
+	const uint64_t now = getJobTime();
+	const uint64_t waitTime = now > job->m_queuedTime ? now - job->m_queuedTime : 0;
+	queuedJobs.fetch_sub(1, std::memory_order_relaxed);
+	executedJobs.fetch_add(1, std::memory_order_relaxed);
+	totalWaitTime.fetch_add(waitTime, std::memory_order_relaxed);
+	uint64_t currentMax = maxWaitTime.load(std::memory_order_relaxed);
+	while (waitTime > currentMax && !maxWaitTime.compare_exchange_weak(currentMax, waitTime, std::memory_order_relaxed));
+}
+
+JobQueueStats WorkerPool::Stats::get() const
+{
+	JobQueueStats stats;
+	stats.queuedJobs = queuedJobs.load(std::memory_order_relaxed);
+	stats.executedJobs = executedJobs.load(std::memory_order_relaxed);
+	stats.averageWaitTime = stats.executedJobs > 0 ? totalWaitTime.load(std::memory_order_relaxed) / stats.executedJobs : 0;
+	stats.maxWaitTime = maxWaitTime.load(std::memory_order_relaxed);
+	return stats;
+}
+
+void WorkerPool::Stats::reset()
+{
+	executedJobs.store(0, std::memory_order_relaxed);
+	totalWaitTime.store(0, std::memory_order_relaxed);
+	maxWaitTime.store(0, std::memory_order_relaxed);
+}
+
 WorkerPool::WorkerPool() :
-	WorkerPool(std::thread::hardware_concurrency())
+	WorkerPool(max<size_t>(std::thread::hardware_concurrency(), 1))
 {
 }
-WorkerPool::WorkerPool(size_t size) :
-	m_running(false)
+WorkerPool::WorkerPool(size_t size, size_t ioSize) :
+	m_sleepingWorkers(0),
+	m_pendingJobs(0),
+	m_queues(mem::akaNewArray<JobQueue>(size * priorityCount, AllocatorMemoryType::Object, AllocatorCategory::Global)),
+	m_activeWorkers(0),
+	m_sleepingIOWorkers(0),
+	m_running(false),
+	m_aborting(false)
 {
+	AKA_ASSERT(size > 0, "Worker pool without workers");
 	m_workers.resize(size);
+	m_ioWorkers.resize(ioSize);
 	start();
 }
 
@@ -22,28 +85,36 @@ WorkerPool::~WorkerPool()
 {
 	stop();
 	wait();
+	reset();
+	mem::akaDeleteArray(m_queues);
 }
 
 void WorkerPool::start()
 {
 	std::unique_lock<std::mutex> lock(m_mutex);
-	if (m_running)
+	if (m_running.load())
 		return;
-	m_running = true;
+	AKA_ASSERT(m_activeWorkers.load() == 0, "Workers from previous run still active");
+	m_running.store(true);
+	m_aborting.store(false);
+	m_activeWorkers.store(static_cast<uint32_t>(m_workers.size() + m_ioWorkers.size()));
 	lock.unlock();
-	for (auto& worker : m_workers)
-		worker = std::thread(&WorkerPool::loop, this);
+	for (uint32_t iWorker = 0; iWorker < m_workers.size(); iWorker++)
+		m_workers[iWorker] = std::thread(&WorkerPool::loop, this, iWorker);
+	for (uint32_t iWorker = 0; iWorker < m_ioWorkers.size(); iWorker++)
+		m_ioWorkers[iWorker] = std::thread(&WorkerPool::loopIO, this);
 }
 
 void WorkerPool::stop()
 {
 	std::unique_lock<std::mutex> lock(m_mutex);
-	if (!m_running)
+	if (!m_running.load())
 		return;
-	m_running = false;
+	m_running.store(false);
 	lock.unlock();
-	m_jobs.clear();
 	m_condition.notify_all();
+	std::lock_guard<std::mutex> ioLock(m_ioMutex);
+	m_ioCondition.notify_all();
 }
 
 void WorkerPool::wait()
@@ -51,76 +122,338 @@ void WorkerPool::wait()
 	for (auto& worker : m_workers)
 		if (worker.joinable())
 			worker.join();
+	for (auto& worker : m_ioWorkers)
+		if (worker.joinable())
+			worker.join();
 }
 
 void WorkerPool::kill()
 {
-	std::unique_lock<std::mutex> lock(m_mutex);
-	if (!m_running)
-		return;
-	m_running = false;
-	for (auto& worker : m_workers)
-		worker.~thread();
+	AKA_ASSERT(s_currentPool != this, "Cannot kill pool from one of its workers");
+	m_aborting.store(true);
+	stop();
+	wait();
+	reset();
 }
 
+bool WorkerPool::shutdown(Time timeout)
+{
+	AKA_ASSERT(s_currentPool != this, "Cannot shutdown pool from one of its workers");
+	stop();
+	std::unique_lock<std::mutex> lock(m_mutex);
+	const bool drained = m_exitCondition.wait_for(lock, std::chrono::milliseconds(timeout.milliseconds()), [this]() {
+		return m_activeWorkers.load() == 0;
+	});
+	lock.unlock();
+	if (!drained)
+	{
+		// Skip remaining jobs, running ones still need to finish.
+		m_aborting.store(true);
+	}
+	wait();
+	// Jobs added by running jobs after workers exited.
+	reset();
+	return drained;
+}
 
 void WorkerPool::reset()
 {
-	std::lock_guard<std::mutex> lock(m_mutex);
-	m_jobs.clear();
+	// Jobs are stolen so that this can be called from any thread.
+	// Finish without executing so that counters & dependencies are still released.
+	while (Job* job = find(invalidWorkerIndex))
+		finish(job);
+	while (Job* job = findIO())
+		finish(job);
 }
 
 bool WorkerPool::isActive() const
 {
-	std::lock_guard<std::mutex> lock(m_mutex);
-	return m_running;
+	return m_running.load();
 }
 
 size_t WorkerPool::size() const
 {
-	std::lock_guard<std::mutex> lock(m_mutex);
-	return m_jobs.size();
+	return m_pendingJobs.load() + m_ioQueue.size();
+}
+
+size_t WorkerPool::count() const
+{
+	return m_workers.size();
+}
+
+size_t WorkerPool::countIO() const
+{
+	return m_ioWorkers.size();
+}
+
+void WorkerPool::addDependency(Job* job, Job* dependency)
+{
+	AKA_ASSERT(job != nullptr && dependency != nullptr, "Invalid job");
+	AKA_ASSERT(job != dependency, "Job cannot depend on itself");
+	AKA_ASSERT(dependency->m_pendingDependencies.load() > 0, "Dependency already running");
+	const uint32_t index = dependency->m_continuationCount.fetch_add(1);
+	AKA_ASSERT(index < Job::maxContinuationCount, "Too many jobs depending on this job");
+	dependency->m_continuations[index] = job;
+	job->m_pendingDependencies.fetch_add(1);
+}
+
+void WorkerPool::run(Job* job, JobCounter* counter, JobPriority priority)
+{
+	AKA_ASSERT(job != nullptr, "Invalid job");
+	AKA_ASSERT(job->m_counter == nullptr, "Job already running");
+	job->m_priority = priority;
+	if (counter)
+	{
+		counter->m_count.fetch_add(1);
+		job->m_counter = counter;
+	}
+	// Release submission dependency.
+	release(job);
+}
+
+void WorkerPool::runIO(Job* job, JobCounter* counter)
+{
+	AKA_ASSERT(job != nullptr, "Invalid job");
+	job->m_io = m_ioWorkers.size() > 0;
+	run(job, counter, JobPriority::Background);
+}
+
+void WorkerPool::wait(const JobCounter& counter, uint32_t value)
+{
+	const bool isWorker = (s_currentPool == this);
+	const bool isIOWorker = isWorker && s_currentIOWorker;
+	const uint32_t workerIndex = (isWorker && !isIOWorker) ? s_currentWorkerIndex : invalidWorkerIndex;
+	while (counter.get() > value)
+	{
+		// Help other workers instead of blocking the thread.
+		// I/O workers only help with I/O jobs so that they never take compute jobs.
+		Job* job = isIOWorker ? findIO() : find(workerIndex);
+		if (job)
+			execute(job);
+		else
+			std::this_thread::yield();
+	}
+}
+
+bool WorkerPool::waitFor(const JobCounter& counter, Time timeout, uint32_t value)
+{
+	const Time deadline = Time::now() + timeout;
+	const bool isWorker = (s_currentPool == this);
+	const bool isIOWorker = isWorker && s_currentIOWorker;
+	const uint32_t workerIndex = (isWorker && !isIOWorker) ? s_currentWorkerIndex : invalidWorkerIndex;
+	while (counter.get() > value)
+	{
+		if (Time::now() >= deadline)
+			return false;
+		Job* job = isIOWorker ? findIO() : find(workerIndex);
+		if (job)
+			execute(job);
+		else
+			std::this_thread::yield();
+	}
+	return true;
+}
+
+JobQueueStats WorkerPool::getStats(JobPriority priority) const
+{
+	return m_stats[EnumToIndex(priority)].get();
+}
+
+JobQueueStats WorkerPool::getIOStats() const
+{
+	return m_ioStats.get();
+}
+
+void WorkerPool::resetStats()
+{
+	for (Stats& stats : m_stats)
+		stats.reset();
+	m_ioStats.reset();
 }
 
 void WorkerPool::add(Job* job)
+{
+	if (job->m_io)
+	{
+		m_ioStats.push(job);
+		m_ioQueue.push(job);
+		if (m_sleepingIOWorkers.load() > 0)
+		{
+			std::lock_guard<std::mutex> lock(m_ioMutex);
+			m_ioCondition.notify_one();
+		}
+		return;
+	}
+	m_stats[EnumToIndex(job->m_priority)].push(job);
+	// Mark job as pending before pushing it so that sleeping workers do not miss it.
+	m_pendingJobs.fetch_add(1);
+	const bool isWorker = (s_currentPool == this && !s_currentIOWorker);
+	if (!isWorker || !getQueue(s_currentWorkerIndex, job->m_priority).push(job))
+		m_sharedQueues[EnumToIndex(job->m_priority)].push(job);
+	if (m_sleepingWorkers.load() > 0)
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_condition.notify_one();
+	}
+}
+
+void WorkerPool::execute(Job* job)
+{
+	// Cancelled jobs are still finished so that counters & dependencies are released.
+	if (!job->isCancelled() && !m_aborting.load(std::memory_order_relaxed))
+		(*job)();
+	finish(job);
+}
+
+void WorkerPool::finish(Job* job)
+{
+	if (job->m_unfinishedJobs.fetch_sub(1) != 1)
+		return; // Some childrens are still running.
+	Job* parent = job->m_parent;
+	JobCounter* counter = job->m_counter;
+	const uint32_t continuationCount = job->m_continuationCount.load();
+	for (uint32_t iContinuation = 0; iContinuation < continuationCount; iContinuation++)
+		release(job->m_continuations[iContinuation]);
+	destroy(job);
+	if (counter)
+		counter->m_count.fetch_sub(1);
+	if (parent)
+		finish(parent);
+}
+
+void WorkerPool::destroy(Job* job)
+{
+	job->~Job();
+	JobAllocator::deallocate(job);
+}
+
+void WorkerPool::release(Job* job)
+{
+	if (job->m_pendingDependencies.fetch_sub(1) == 1)
+		add(job);
+}
+
+Job* WorkerPool::find(uint32_t workerIndex)
+{
+	if (m_pendingJobs.load() == 0)
+		return nullptr;
+	const uint32_t workerCount = static_cast<uint32_t>(m_workers.size());
+	const uint32_t startIndex = (workerIndex == invalidWorkerIndex) ? 0 : workerIndex + 1;
+	for (JobPriority priority : EnumRange<JobPriority>())
+	{
+		Job* job = nullptr;
+		// Own queue first
+		if (workerIndex != invalidWorkerIndex)
+			job = getQueue(workerIndex, priority).pop();
+		// Then jobs submitted from outside
+		if (job == nullptr)
+			job = m_sharedQueues[EnumToIndex(priority)].pop();
+		// Then steal from other workers
+		for (uint32_t iWorker = 0; job == nullptr && iWorker < workerCount; iWorker++)
+		{
+			const uint32_t victimIndex = (startIndex + iWorker) % workerCount;
+			if (victimIndex == workerIndex)
+				continue;
+			job = getQueue(victimIndex, priority).steal();
+		}
+		if (job)
+		{
+			m_pendingJobs.fetch_sub(1);
+			m_stats[EnumToIndex(priority)].pop(job);
+			return job;
+		}
+	}
+	return nullptr;
+}
+
+Job* WorkerPool::findIO()
+{
+	Job* job = m_ioQueue.pop();
+	if (job)
+		m_ioStats.pop(job);
+	return job;
+}
+
+void WorkerPool::sleep()
 {
 	std::unique_lock<std::mutex> lock(m_mutex);
-	m_jobs.push_back(job);
-	lock.unlock();
-	m_condition.notify_all();
+	m_sleepingWorkers.fetch_add(1);
+	while (m_pendingJobs.load() == 0 && m_running.load())
+		m_condition.wait(lock);
+	m_sleepingWorkers.fetch_sub(1);
 }
 
-void WorkerPool::loop()
+void WorkerPool::sleepIO()
 {
+	std::unique_lock<std::mutex> lock(m_ioMutex);
+	m_sleepingIOWorkers.fetch_add(1);
+	while (m_ioQueue.empty() && m_running.load())
+		m_ioCondition.wait(lock);
+	m_sleepingIOWorkers.fetch_sub(1);
+}
+
+void WorkerPool::exit()
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	if (m_activeWorkers.fetch_sub(1) == 1)
+		m_exitCondition.notify_all();
+}
+
+JobQueue& WorkerPool::getQueue(uint32_t workerIndex, JobPriority priority)
+{
+	return m_queues[workerIndex * priorityCount + EnumToIndex(priority)];
+}
+
+void WorkerPool::loop(uint32_t workerIndex)
+{
+	s_currentPool = this;
+	s_currentWorkerIndex = workerIndex;
+	while (true)
+	{
+		Job* job = find(workerIndex);
+		if (job)
+		{
+			execute(job);
+		}
+		else if (!m_running.load() && m_pendingJobs.load() == 0)
+		{
+			// Stop once every queued job is done.
+			break;
+		}
+		else
+		{
+			sleep();
+		}
+	}
+	s_currentPool = nullptr;
+	s_currentWorkerIndex = invalidWorkerIndex;
+	exit();
+}
+
+void WorkerPool::loopIO()
+{
+	s_currentPool = this;
+	s_currentIOWorker = true;
 	while (true)
 	{
-		std::list<Job*> localQueue;
+		Job* job = findIO();
+		if (job)
+		{
+			execute(job);
+		}
+		else if (!m_running.load() && m_ioQueue.empty())
 		{
-			std::unique_lock<std::mutex> lock(m_mutex);
-			while (m_jobs.empty() && m_running)
-				m_condition.wait(lock);
-
-			if (!m_running)
-			{
-				// Stop if not running
-				for (auto& job : m_jobs)
-				{
-					(*job)();
-					mem::akaDelete(job);
-				}
-				m_jobs.clear();
-				return;
-			}
-			localQueue = std::move(m_jobs);
-			m_jobs.clear();
+			// Stop once every queued job is done.
+			break;
 		}
-		// Free the queue.
-		for (auto& job : localQueue)
+		else
 		{
-			(*job)();
-			mem::akaDelete(job);
+			sleepIO();
 		}
 	}
+	s_currentPool = nullptr;
+	s_currentIOWorker = false;
+	exit();
 }
 
-};
\ No newline at end of file
+};
@@ -13,6 +13,8 @@
 #include "VulkanDebug.h"
 #include "VulkanCommon.hpp"
 
+#include <unordered_map>
+
 #include <Aka/Memory/Pool.h>
 #include <Aka/Core/Config.h>
 #include <Aka/OS/OS.h>
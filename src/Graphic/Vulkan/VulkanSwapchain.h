@@ -1,5 +1,7 @@
 #pragma once
 
+#include <unordered_map>
+
 #include "VulkanCommon.hpp"
 #include <Aka/Core/Container/Vector.h>
 #include <Aka/Graphic/Swapchain.h>
@@ -93,6 +93,11 @@ size_t Allocator::alignAdjustment(uintptr_t address, size_t alignment)
 	return adjustment;
 }
 
+MemoryBlock* Allocator::getFirstMemoryBlock()
+{
+	return m_memory;
+}
+
 MemoryBlock* Allocator::getMemoryBlock()
 {
 	MemoryBlock* block = m_memory;
@@ -130,6 +135,31 @@ MemoryBlock* Allocator::requestNewMemoryBlock()
 	}
 }
 
+void Allocator::untrackRange(const void* begin, const void* end)
+{
+#if defined(AKA_TRACK_MEMORY_ALLOCATIONS)
+	getAllocatorTracker().deallocateRange(begin, end, m_type, m_category);
+#else
+	AKA_UNUSED(begin);
+	AKA_UNUSED(end);
+#endif
+}
+
+void Allocator::acquireBudget(size_t size)
+{
+	if (m_parent != nullptr)
+		return; // Memory is charged to the parent when blocks are requested.
+	if (!getAllocatorBudgets().acquire(m_category, size))
+		throw std::bad_alloc();
+}
+
+void Allocator::releaseBudget(size_t size)
+{
+	if (m_parent != nullptr || size == 0)
+		return;
+	getAllocatorBudgets().release(m_category, size);
+}
+
 void Allocator::releaseAllMemoryBlocks()
 {
 	if (m_memory)
@@ -141,6 +171,7 @@ void Allocator::releaseAllMemoryBlocks()
 			{
 				m_parent->deallocate((uint8_t*)block->mem);
 				MemoryBlock* nextBlock = block->next;
+				block->next = nullptr; // Block destructor delete next blocks.
 				delete block;
 				block = nextBlock;
 			}
@@ -1,42 +1,93 @@
 #include <Aka/Memory/Allocator/LinearAllocator.h>
 
+#include <Aka/Memory/Memory.h>
+
+#include <algorithm>
+
 namespace aka {
 
-LinearAllocator::LinearAllocator(const char* name, AllocatorMemoryType memoryType, AllocatorCategory category, Allocator* parent = nullptr, size_t blockSize = 0) :
-	Allocator(name, memoryType, category),
-	m_offset(0)
+LinearAllocator::Scope::Scope(LinearAllocator& allocator) :
+	m_allocator(allocator),
+	m_marker(allocator.getMarker())
+{
+}
+
+LinearAllocator::Scope::~Scope()
 {
+	m_allocator.rewind(m_marker);
+}
 
+LinearAllocator::LinearAllocator(const char* name, AllocatorMemoryType memoryType, AllocatorCategory category, Allocator* parent, size_t blockSize) :
+	Allocator(name, memoryType, category, parent, blockSize),
+	m_block(getFirstMemoryBlock()),
+	m_offset(0),
+	m_last(nullptr)
+{
 }
 
 LinearAllocator::~LinearAllocator()
 {
+}
 
+LinearAllocator::Marker LinearAllocator::getMarker() const
+{
+	return Marker{ m_block, m_offset };
 }
 
-void* LinearAllocator::allocate_internal(size_t size, AllocatorFlags flags)
+void LinearAllocator::rewind(Marker marker)
 {
-	MemoryBlock* block = getMemoryBlock();
-	if (size + m_offset > block->size)
+	AKA_ASSERT(marker.block != nullptr, "Invalid marker");
+	// Untrack everything between marker & current position.
+	MemoryBlock* block = marker.block;
+	size_t offset = marker.offset;
+	while (true)
 	{
-		block = requestNewMemoryBlock(); // Out of memory
-		m_offset = 0; // Reset offset
+		uint8_t* mem = static_cast<uint8_t*>(block->mem);
+		const size_t end = (block == m_block) ? m_offset : block->size;
+		untrackRange(mem + offset, mem + end);
+		if (block == m_block)
+			break;
+		block = block->next;
+		offset = 0;
+		AKA_ASSERT(block != nullptr, "Marker is after current position");
 	}
-	size_t offset = m_offset;
-	m_offset += size;
-	return static_cast<uint8_t*>(block->mem) + offset;
+	m_block = marker.block;
+	m_offset = marker.offset;
+	m_last = nullptr;
+}
+
+void LinearAllocator::reset()
+{
+	rewind(Marker{ getFirstMemoryBlock(), 0 });
+}
+
+size_t LinearAllocator::used() const
+{
+	size_t used = m_offset;
+	for (const MemoryBlock* block = const_cast<LinearAllocator*>(this)->getFirstMemoryBlock(); block != m_block; block = block->next)
+		used += block->size;
+	return used;
+}
+
+void* LinearAllocator::allocate_internal(size_t size, AllocatorFlags flags)
+{
+	return alignedAllocate_internal(size, alignof(std::max_align_t), flags);
 }
+
 void* LinearAllocator::alignedAllocate_internal(size_t size, size_t alignement, AllocatorFlags flags)
 {
-	MemoryBlock* block = getMemoryBlock();
-	if (size + m_offset > block->size)
+	AKA_UNUSED(flags);
+	uintptr_t aligned = align(reinterpret_cast<uintptr_t>(m_block->mem) + m_offset, alignement);
+	if (aligned + size > reinterpret_cast<uintptr_t>(m_block->mem) + m_block->size)
 	{
-		block = requestNewMemoryBlock(); // Out of memory
-		m_offset = 0; // Reset offset
+		// Out of memory, use next block, which is free if any.
+		m_block = (m_block->next != nullptr) ? m_block->next : requestNewMemoryBlock();
+		AKA_ASSERT(alignement + size <= m_block->size, "Allocation bigger than block size");
+		aligned = align(reinterpret_cast<uintptr_t>(m_block->mem), alignement);
 	}
-	size_t offset = m_offset + alignAdjustment((uintptr_t)block->mem + m_offset, alignement);
-	m_offset = offset + size;
-	return static_cast<uint8_t*>(block->mem) + offset;
+	m_offset = aligned + size - reinterpret_cast<uintptr_t>(m_block->mem);
+	m_last = reinterpret_cast<void*>(aligned);
+	return m_last;
 }
 
 void LinearAllocator::deallocate_internal(void* address)
@@ -53,17 +104,43 @@ void LinearAllocator::alignedDeallocate_internal(void* address)
 
 void* LinearAllocator::reallocate_internal(void* elements, size_t size, AllocatorFlags flags)
 {
-	AKA_UNUSED(elements);
-	// Linear allocator does not need to deallocate.
-	return allocate_internal(size);
+	return alignedReallocate_internal(elements, size, alignof(std::max_align_t), flags);
 }
 
 void* LinearAllocator::alignedReallocate_internal(void* elements, size_t size, size_t alignment, AllocatorFlags flags)
 {
-	AKA_UNUSED(elements);
-	// Linear allocator does not need to deallocate.
-	return alignedAllocate_internal(alignment, size);
+	if (elements == nullptr)
+		return alignedAllocate_internal(size, alignment, flags);
+	uint8_t* mem = static_cast<uint8_t*>(m_block->mem);
+	if (elements == m_last && static_cast<uint8_t*>(elements) + size <= mem + m_block->size)
+	{
+		// Last allocation, grow in place.
+		m_offset = static_cast<uint8_t*>(elements) + size - mem;
+		return elements;
+	}
+	// Allocation size is not stored, so copy everything up to the end of its allocated range.
+	// Old allocation stays in the arena until it is reset.
+	size_t available = 0;
+	if (elements >= m_block->mem && elements < mem + m_offset)
+	{
+		available = mem + m_offset - static_cast<uint8_t*>(elements);
+	}
+	else
+	{
+		for (MemoryBlock* block = getFirstMemoryBlock(); block != m_block; block = block->next)
+		{
+			uint8_t* blockMem = static_cast<uint8_t*>(block->mem);
+			if (elements >= blockMem && elements < blockMem + block->size)
+			{
+				available = blockMem + block->size - static_cast<uint8_t*>(elements);
+				break;
+			}
+		}
+		AKA_ASSERT(available > 0, "Reallocating memory not owned by allocator");
+	}
+	void* data = alignedAllocate_internal(size, alignment, flags);
+	Memory::copy(data, elements, std::min(size, available));
+	return data;
 }
 
-
 };
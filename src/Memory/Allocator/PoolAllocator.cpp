@@ -1,59 +1,102 @@
 #include <Aka/Memory/Allocator/PoolAllocator.h>
 
+#include <algorithm>
+
 namespace aka {
 
-/*PoolAllocator::PoolAllocator(void* mem, size_t size, size_t objectSize, size_t objectAlignment) :
-	Allocator(mem, size),
+PoolAllocator::PoolAllocator(const char* name, AllocatorMemoryType memoryType, AllocatorCategory category, Allocator* parent, size_t blockSize, size_t objectSize, size_t objectAlignment) :
+	Allocator(name, memoryType, category, parent, blockSize),
+	m_objectSize(align(std::max(objectSize, sizeof(void*)), objectAlignment)), // Free objects store next pointer.
 	m_objectAlignment(objectAlignment),
 	m_objectCount(0),
-	m_objectSize(objectSize),
 	m_freeList(nullptr)
 {
-	// We use object memory to store next pointer, so space needs to be bigger
-	AKA_ASSERT(objectSize >= sizeof(void*), "Object size needs to be bigger than sizeof(void*)");
-	reset();
+	AKA_ASSERT(blockSize >= m_objectSize + m_objectAlignment, "Block too small for a single object");
+	addToFreeList(getFirstMemoryBlock());
 }
 
 PoolAllocator::~PoolAllocator()
 {
 }
 
-void* PoolAllocator::allocate(size_t size, size_t alignment)
+void PoolAllocator::reset()
 {
-	AKA_ASSERT(size == m_objectSize && alignment == m_objectAlignment, "Invalid size or alignment.");
-	if (m_freeList == nullptr) return nullptr;
-	void* p = m_freeList;
-	m_freeList = (void**)(*m_freeList);
-	m_used += size;
-	return p;
+	m_freeList = nullptr;
+	m_objectCount = 0;
+	for (MemoryBlock* block = getFirstMemoryBlock(); block != nullptr; block = block->next)
+	{
+		untrackRange(block->mem, static_cast<uint8_t*>(block->mem) + block->size);
+		addToFreeList(block);
+	}
 }
 
-void PoolAllocator::deallocate(void* address, size_t size)
+size_t PoolAllocator::count() const
 {
-	AKA_ASSERT(address > m_mem && (uintptr_t)address < (uintptr_t)m_mem + m_size, "Invalid range");
-	AKA_ASSERT(size == m_objectSize, "Invalid size.");
-	*((void**)address) = m_freeList;
-	m_freeList = (void**)address;
-	m_used -= size;
+	return m_objectCount;
 }
 
-void PoolAllocator::reset()
+void PoolAllocator::addToFreeList(MemoryBlock* block)
 {
-	size_t adjustment = Allocator::alignAdjustment((uintptr_t)m_mem, m_objectAlignment);
-	m_freeList = (void**)((uintptr_t)m_mem + adjustment);
-	m_objectCount = (m_size - adjustment) / m_objectSize;
-	void** p = m_freeList;
-	for (size_t i = 0; i < m_objectCount - 1; i++)
+	const uintptr_t start = align(reinterpret_cast<uintptr_t>(block->mem), m_objectAlignment);
+	const uintptr_t end = reinterpret_cast<uintptr_t>(block->mem) + block->size;
+	const size_t count = (end - start) / m_objectSize;
+	// Push in reverse so that objects are allocated in address order.
+	for (size_t iObject = count; iObject > 0; iObject--)
 	{
-		*p = (void*)((uintptr_t)p + m_objectSize);
-		p = (void**)*p;
+		void** object = reinterpret_cast<void**>(start + (iObject - 1) * m_objectSize);
+		*object = m_freeList;
+		m_freeList = object;
 	}
-	*p = nullptr; // last item.
 }
 
-bool PoolAllocator::contiguous() const
+void* PoolAllocator::allocate_internal(size_t size, AllocatorFlags flags)
+{
+	AKA_UNUSED(flags);
+	AKA_UNUSED(size);
+	AKA_ASSERT(size <= m_objectSize, "Allocation bigger than pool object size");
+	if (m_freeList == nullptr)
+		addToFreeList(requestNewMemoryBlock()); // Out of memory
+	void** object = m_freeList;
+	m_freeList = static_cast<void**>(*object);
+	m_objectCount++;
+	return object;
+}
+
+void* PoolAllocator::alignedAllocate_internal(size_t size, size_t alignement, AllocatorFlags flags)
+{
+	AKA_UNUSED(alignement);
+	AKA_ASSERT(alignement <= m_objectAlignment, "Alignment bigger than pool object alignment");
+	return allocate_internal(size, flags);
+}
+
+void PoolAllocator::deallocate_internal(void* elements)
 {
-	return false;
-}*/
+	AKA_ASSERT(m_objectCount > 0, "Deallocating from empty pool");
+	void** object = static_cast<void**>(elements);
+	*object = m_freeList;
+	m_freeList = object;
+	m_objectCount--;
+}
+
+void PoolAllocator::alignedDeallocate_internal(void* elements)
+{
+	deallocate_internal(elements);
+}
+
+void* PoolAllocator::reallocate_internal(void* elements, size_t size, AllocatorFlags flags)
+{
+	// Objects have a fixed size, so they can only be reused.
+	AKA_ASSERT(size <= m_objectSize, "Reallocation bigger than pool object size");
+	if (elements == nullptr)
+		return allocate_internal(size, flags);
+	return elements;
+}
+
+void* PoolAllocator::alignedReallocate_internal(void* elements, size_t size, size_t alignment, AllocatorFlags flags)
+{
+	AKA_UNUSED(alignment);
+	AKA_ASSERT(alignment <= m_objectAlignment, "Alignment bigger than pool object alignment");
+	return reallocate_internal(elements, size, flags);
+}
 
 };
@@ -0,0 +1,113 @@
+#include <Aka/Memory/Allocator/RingAllocator.h>
+
+namespace aka {
+
+RingAllocator::RingAllocator(const char* name, AllocatorMemoryType memoryType, AllocatorCategory category, Allocator* parent, size_t blockSize) :
+	Allocator(name, memoryType, category, parent, blockSize),
+	m_head(0),
+	m_tail(0)
+{
+}
+
+RingAllocator::~RingAllocator()
+{
+}
+
+RingAllocator::Marker RingAllocator::getMarker() const
+{
+	return m_head;
+}
+
+void RingAllocator::release(Marker marker)
+{
+	AKA_ASSERT(marker >= m_tail && marker <= m_head, "Invalid marker");
+	MemoryBlock* block = getFirstMemoryBlock();
+	uint8_t* mem = static_cast<uint8_t*>(block->mem);
+	const size_t begin = static_cast<size_t>(m_tail % block->size);
+	const size_t end = static_cast<size_t>(marker % block->size);
+	if (marker - m_tail >= block->size)
+	{
+		untrackRange(mem, mem + block->size);
+	}
+	else if (begin <= end)
+	{
+		untrackRange(mem + begin, mem + end);
+	}
+	else
+	{
+		// Released range wrap around.
+		untrackRange(mem + begin, mem + block->size);
+		untrackRange(mem, mem + end);
+	}
+	m_tail = marker;
+}
+
+void RingAllocator::reset()
+{
+	release(m_head);
+}
+
+size_t RingAllocator::used() const
+{
+	return static_cast<size_t>(m_head - m_tail);
+}
+
+void* RingAllocator::allocate_internal(size_t size, AllocatorFlags flags)
+{
+	return alignedAllocate_internal(size, alignof(std::max_align_t), flags);
+}
+
+void* RingAllocator::alignedAllocate_internal(size_t size, size_t alignement, AllocatorFlags flags)
+{
+	AKA_UNUSED(flags);
+	MemoryBlock* block = getFirstMemoryBlock();
+	const uintptr_t mem = reinterpret_cast<uintptr_t>(block->mem);
+	size_t offset = static_cast<size_t>(m_head % block->size);
+	size_t adjustment = alignAdjustment(mem + offset, alignement);
+	uint64_t head = m_head;
+	if (offset + adjustment + size > block->size)
+	{
+		// Not enough space at the end, wrap around & waste the end of the block.
+		head += block->size - offset;
+		offset = 0;
+		adjustment = alignAdjustment(mem, alignement);
+	}
+	head += adjustment + size;
+	if (head - m_tail > block->size)
+	{
+		// Ring full, tail not released fast enough.
+		throw std::bad_alloc();
+	}
+	m_head = head;
+	return reinterpret_cast<void*>(mem + offset + adjustment);
+}
+
+void RingAllocator::deallocate_internal(void* elements)
+{
+	AKA_UNUSED(elements);
+	// Memory is released in order with release.
+}
+
+void RingAllocator::alignedDeallocate_internal(void* elements)
+{
+	AKA_UNUSED(elements);
+	// Memory is released in order with release.
+}
+
+void* RingAllocator::reallocate_internal(void* elements, size_t size, AllocatorFlags flags)
+{
+	// Allocation sizes are not stored, so old content could not be copied.
+	if (elements != nullptr)
+		AKA_CRASH("Ring allocations cannot be reallocated");
+	return allocate_internal(size, flags);
+}
+
+void* RingAllocator::alignedReallocate_internal(void* elements, size_t size, size_t alignment, AllocatorFlags flags)
+{
+	// Allocation sizes are not stored, so old content could not be copied.
+	if (elements != nullptr)
+		AKA_CRASH("Ring allocations cannot be reallocated");
+	return alignedAllocate_internal(size, alignment, flags);
+}
+
+};
@@ -0,0 +1,119 @@
+#include <Aka/Memory/Allocator/StackAllocator.h>
+
+#include <Aka/Memory/Memory.h>
+
+#include <algorithm>
+
+namespace aka {
+
+StackAllocator::StackAllocator(const char* name, AllocatorMemoryType memoryType, AllocatorCategory category, Allocator* parent, size_t blockSize) :
+	Allocator(name, memoryType, category, parent, blockSize),
+	m_block(getFirstMemoryBlock()),
+	m_offset(0)
+{
+}
+
+StackAllocator::~StackAllocator()
+{
+}
+
+StackAllocator::Marker StackAllocator::getMarker() const
+{
+	return Marker{ m_block, m_offset };
+}
+
+void StackAllocator::rewind(Marker marker)
+{
+	AKA_ASSERT(marker.block != nullptr, "Invalid marker");
+	// Untrack everything between marker & current top.
+	MemoryBlock* block = marker.block;
+	size_t offset = marker.offset;
+	while (true)
+	{
+		uint8_t* mem = static_cast<uint8_t*>(block->mem);
+		const size_t end = (block == m_block) ? m_offset : block->size;
+		untrackRange(mem + offset, mem + end);
+		if (block == m_block)
+			break;
+		block = block->next;
+		offset = 0;
+		AKA_ASSERT(block != nullptr, "Marker is above top of the stack");
+	}
+	m_block = marker.block;
+	m_offset = marker.offset;
+}
+
+void StackAllocator::reset()
+{
+	rewind(Marker{ getFirstMemoryBlock(), 0 });
+}
+
+StackAllocator::Header* StackAllocator::getHeader(void* elements)
+{
+	return reinterpret_cast<Header*>(static_cast<uint8_t*>(elements) - sizeof(Header));
+}
+
+void* StackAllocator::allocate_internal(size_t size, AllocatorFlags flags)
+{
+	return alignedAllocate_internal(size, alignof(std::max_align_t), flags);
+}
+
+void* StackAllocator::alignedAllocate_internal(size_t size, size_t alignement, AllocatorFlags flags)
+{
+	AKA_UNUSED(flags);
+	const Marker previous = getMarker();
+	uintptr_t start = reinterpret_cast<uintptr_t>(m_block->mem) + m_offset;
+	uintptr_t aligned = align(start + sizeof(Header), alignement);
+	if (aligned + size > reinterpret_cast<uintptr_t>(m_block->mem) + m_block->size)
+	{
+		// Out of memory, use next block, which is free if any.
+		m_block = (m_block->next != nullptr) ? m_block->next : requestNewMemoryBlock();
+		AKA_ASSERT(sizeof(Header) + alignement + size <= m_block->size, "Allocation bigger than block size");
+		start = reinterpret_cast<uintptr_t>(m_block->mem);
+		aligned = align(start + sizeof(Header), alignement);
+	}
+	Header* header = getHeader(reinterpret_cast<void*>(aligned));
+	header->previous = previous;
+	header->size = size;
+	m_offset = aligned + size - reinterpret_cast<uintptr_t>(m_block->mem);
+	return reinterpret_cast<void*>(aligned);
+}
+
+void StackAllocator::deallocate_internal(void* elements)
+{
+	Header* header = getHeader(elements);
+	AKA_ASSERT(static_cast<uint8_t*>(elements) + header->size == static_cast<uint8_t*>(m_block->mem) + m_offset, "Deallocation is not at the top of the stack");
+	m_block = header->previous.block;
+	m_offset = header->previous.offset;
+}
+
+void StackAllocator::alignedDeallocate_internal(void* elements)
+{
+	deallocate_internal(elements);
+}
+
+void* StackAllocator::reallocate_internal(void* elements, size_t size, AllocatorFlags flags)
+{
+	return alignedReallocate_internal(elements, size, alignof(std::max_align_t), flags);
+}
+
+void* StackAllocator::alignedReallocate_internal(void* elements, size_t size, size_t alignment, AllocatorFlags flags)
+{
+	if (elements == nullptr)
+		return alignedAllocate_internal(size, alignment, flags);
+	Header* header = getHeader(elements);
+	uint8_t* top = static_cast<uint8_t*>(m_block->mem) + m_offset;
+	if (static_cast<uint8_t*>(elements) + header->size == top && static_cast<uint8_t*>(elements) + size <= static_cast<uint8_t*>(m_block->mem) + m_block->size)
+	{
+		// Top of the stack, grow in place.
+		header->size = size;
+		m_offset = static_cast<uint8_t*>(elements) + size - static_cast<uint8_t*>(m_block->mem);
+		return elements;
+	}
+	// Old allocation stays in the stack until it is rewinded.
+	void* data = alignedAllocate_internal(size, alignment, flags);
+	Memory::copy(data, elements, std::min(size, header->size));
+	return data;
+}
+
+};
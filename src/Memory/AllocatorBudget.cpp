@@ -0,0 +1,80 @@
+#include <Aka/Memory/AllocatorBudget.hpp>
+
+#include <Aka/Core/Config.h>
+
+namespace aka {
+
+AllocatorBudgets::AllocatorBudgets() :
+	m_budgets{},
+	m_used{}
+{
+}
+
+void AllocatorBudgets::set(AllocatorCategory category, const AllocatorBudget& budget)
+{
+	AKA_ASSERT(budget.softLimit == 0 || budget.hardLimit == 0 || budget.softLimit <= budget.hardLimit, "Soft limit above hard limit");
+	AKA_ASSERT(budget.policy != AllocatorBudgetPolicy::Evict || budget.onEvict, "Evict policy without callback");
+	m_budgets[EnumToIndex(category)] = budget;
+}
+
+const AllocatorBudget& AllocatorBudgets::get(AllocatorCategory category) const
+{
+	return m_budgets[EnumToIndex(category)];
+}
+
+size_t AllocatorBudgets::getUsedMemory(AllocatorCategory category) const
+{
+	return m_used[EnumToIndex(category)].load(std::memory_order_relaxed);
+}
+
+bool AllocatorBudgets::acquire(AllocatorCategory category, size_t size)
+{
+	const AllocatorBudget& budget = m_budgets[EnumToIndex(category)];
+	std::atomic<size_t>& used = m_used[EnumToIndex(category)];
+	const size_t previous = used.fetch_add(size, std::memory_order_relaxed);
+	const size_t current = previous + size;
+	if (budget.hardLimit > 0 && current > budget.hardLimit)
+	{
+		switch (budget.policy)
+		{
+		default:
+		case AllocatorBudgetPolicy::Assert:
+			AKA_ASSERT(false, "Allocator category over budget");
+			break;
+		case AllocatorBudgetPolicy::Fail:
+			used.fetch_sub(size, std::memory_order_relaxed);
+			return false;
+		case AllocatorBudgetPolicy::Evict: {
+			// Evicted memory is released through deallocations, so do not count this allocation meanwhile.
+			used.fetch_sub(size, std::memory_order_relaxed);
+			budget.onEvict(category, current - budget.hardLimit);
+			const size_t retry = used.fetch_add(size, std::memory_order_relaxed) + size;
+			if (retry > budget.hardLimit)
+			{
+				used.fetch_sub(size, std::memory_order_relaxed);
+				return false;
+			}
+			return true;
+		}
+		}
+	}
+	// Only notify when crossing the limit, not on every allocation above it.
+	if (budget.softLimit > 0 && previous <= budget.softLimit && current > budget.softLimit && budget.onSoftLimit)
+		budget.onSoftLimit(category, current, budget.softLimit);
+	return true;
+}
+
+void AllocatorBudgets::release(AllocatorCategory category, size_t size)
+{
+	std::atomic<size_t>& used = m_used[EnumToIndex(category)];
+	AKA_ASSERT(used.load(std::memory_order_relaxed) >= size, "Releasing more memory than acquired");
+	used.fetch_sub(size, std::memory_order_relaxed);
+}
+
+AllocatorBudgets& getAllocatorBudgets()
+{
+	static AllocatorBudgets s_instance;
+	return s_instance;
+}
+
+};
@@ -5,16 +5,52 @@
 
 #include <iostream>
 #include <vector>
+#include <tuple>
+#include <stdio.h>
+#include <string.h>
 
 namespace aka {
 
 #if defined(AKA_TRACK_MEMORY_ALLOCATIONS)
 
-AllocatorTracker::AllocatorTracker() 
+size_t AllocatorStats::getHistogramBucket(size_t size)
+{
+	size_t bucket = 0;
+	while (size > 1 && bucket < HistogramBucketCount - 1)
+	{
+		size >>= 1;
+		bucket++;
+	}
+	return bucket;
+}
+
+AllocatorStats& AllocatorStats::operator+=(const AllocatorStats& stats)
+{
+	liveBytes += stats.liveBytes;
+	peakBytes += stats.peakBytes; // Peaks might not be reached at the same time, so this is an upper bound.
+	allocatedBytes += stats.allocatedBytes;
+	deallocatedBytes += stats.deallocatedBytes;
+	allocationCount += stats.allocationCount;
+	deallocationCount += stats.deallocationCount;
+	for (size_t i = 0; i < HistogramBucketCount; i++)
+		histogram[i] += stats.histogram[i];
+	return *this;
+}
+
+AllocatorTracker::AllocatorTracker() :
+	m_callStackSampling(0),
+	m_leakReportPath{}
 {
 }
 AllocatorTracker::~AllocatorTracker()
 {
+	if (m_leakReportPath[0] != '\0')
+	{
+		if (takeSnapshot().exportJSON(m_leakReportPath))
+			std::cout << "Leak report exported to " << m_leakReportPath << std::endl;
+		else
+			std::cout << "Failed to export leak report to " << m_leakReportPath << std::endl;
+	}
 	size_t totalLeak = 0;
 	for (AllocatorMemoryType type : EnumRange<AllocatorMemoryType>())
 	{
@@ -22,22 +58,23 @@ AllocatorTracker::~AllocatorTracker()
 		for (AllocatorCategory category : EnumRange<AllocatorCategory>())
 		{
 			size_t totalLeakCategory = 0;
-			const AllocatorTrackingData& data = m_data[EnumToIndex(type)][EnumToIndex(category)];
-			std::cout << "	AllocatorCategory::" << toString(category) << ": " << data.m_allocation << " allocations" << " for " << data.m_memoryDeallocated << " bytes" << std::endl;
-			const bool isLeaking = data.m_allocations.size() > 0;
+			const AllocatorStats stats = getStats(type, category);
+			std::cout << "	AllocatorCategory::" << toString(category) << ": " << stats.allocationCount << " allocations" << " for " << stats.allocatedBytes << " bytes (peak " << stats.peakBytes << " bytes)" << std::endl;
+			const bool isLeaking = stats.getLiveAllocationCount() > 0;
 			if (isLeaking)
 			{
-				std::cout << "		" << data.m_allocation << " allocations for " << data.m_memoryAllocated << " bytes" << std::endl;
-				std::cout << "		" << data.m_deallocation << " deallocations for " << data.m_memoryDeallocated << " bytes" << std::endl;
-				std::cout << "		" << data.m_allocation - data.m_deallocation << " allocation leak detected for " << data.m_memoryAllocated - data.m_memoryDeallocated << " bytes" << std::endl;
-			}
-			if (isLeaking) {
+				std::cout << "		" << stats.allocationCount << " allocations for " << stats.allocatedBytes << " bytes" << std::endl;
+				std::cout << "		" << stats.deallocationCount << " deallocations for " << stats.deallocatedBytes << " bytes" << std::endl;
+				std::cout << "		" << stats.getLiveAllocationCount() << " allocation leak detected for " << stats.liveBytes << " bytes" << std::endl;
 				std::cout << "		--" << std::endl;
-				for (const auto& alloc : data.m_allocations)
+				for (Shard& shard : m_shards)
 				{
-					const AllocationTrackingData& data = alloc.second;
-					std::cout << "		Leaking " << data.info->name() << " (size(" << data.elementSize << " bytes) count(" << data.count << "))" << std::endl;
-					totalLeakCategory += data.elementSize * data.count;
+					for (const auto& alloc : shard.allocations[EnumToIndex(type)][EnumToIndex(category)])
+					{
+						const AllocationTrackingData& data = alloc.second;
+						std::cout << "		Leaking " << data.info->name() << " (size(" << data.elementSize << " bytes) count(" << data.count << "))" << std::endl;
+						totalLeakCategory += data.elementSize * data.count;
+					}
 				}
 				std::cout << "		--" << std::endl;
 				std::cout << "		Total leaks category detected : " << totalLeakCategory << " bytes" << std::endl;
@@ -48,6 +85,20 @@ AllocatorTracker::~AllocatorTracker()
 	std::cout << "Total leaks detected : " << totalLeak << " bytes" << std::endl;
 }
 
+std::atomic<size_t>& AllocatorTracker::getUsedMemoryCounter()
+{
+	static std::atomic<size_t> s_used = 0;
+	return s_used;
+}
+
+AllocatorTracker::Shard& AllocatorTracker::getShard(const void* pointer) const
+{
+	// Fibonacci hashing of the address, skipping low bits which are mostly aligned.
+	static_assert(ShardCount == 1 << 4, "Invalid shard count");
+	const uint64_t hash = (static_cast<uint64_t>(reinterpret_cast<uintptr_t>(pointer)) >> 4) * 0x9E3779B97F4A7C15ULL;
+	return m_shards[hash >> (64 - 4)];
+}
+
 void AllocatorTracker::allocate(const void* const pointer, AllocatorMemoryType type, AllocatorCategory category, const AllocationTrackingData& data)
 {
 	if (pointer == nullptr)
@@ -56,85 +107,303 @@ void AllocatorTracker::allocate(const void* const pointer, AllocatorMemoryType t
 	AKA_ASSERT(EnumIsInRange(type), "Invalid allocator type");
 	AKA_ASSERT(EnumIsInRange(category), "Invalid allocator category");
 	AKA_ASSERT(data.elementSize > 0, "Invalid allocation");
-	AllocatorTrackingData& tracking = m_data[EnumToIndex(type)][EnumToIndex(category)];
-	tracking.m_allocation += 1;
-	tracking.m_memoryAllocated += data.elementSize * data.count;
-	tracking.m_allocations.insert(std::make_pair(pointer, data));
-	// Fill memory infos
-	auto it = tracking.m_typeAllocations.find(data.info);
-	if (it == tracking.m_typeAllocations.end())
-	{
-		tracking.m_typeAllocations.insert(std::make_pair(data.info, AllocatorTrackingData::TypeAllocationInfo{ data.count, data.elementSize, 1 }));
-	}
-	else
+	const size_t size = data.elementSize * data.count;
+	const uint64_t callStack = captureCallStack();
 	{
-		AllocatorTrackingData::TypeAllocationInfo& typeInfo = tracking.m_typeAllocations[data.info];
-		AKA_ASSERT(typeInfo.elementSize == data.elementSize, "Mismatching element size");
-		typeInfo.count += data.count;
-		typeInfo.uniqueAllocation++;
+		Shard& shard = getShard(pointer);
+		std::lock_guard<std::mutex> lock(shard.mutex);
+		auto result = shard.allocations[EnumToIndex(type)][EnumToIndex(category)].insert(std::make_pair(pointer, data));
+		if (!result.second)
+			return; // Already tracked, keep its original call site.
+		result.first->second.callStack = callStack;
 	}
+	Counters& counters = m_counters[EnumToIndex(type)][EnumToIndex(category)];
+	counters.allocationCount.fetch_add(1, std::memory_order_relaxed);
+	counters.allocatedBytes.fetch_add(size, std::memory_order_relaxed);
+	counters.histogram[AllocatorStats::getHistogramBucket(size)].fetch_add(1, std::memory_order_relaxed);
+	const size_t live = counters.liveBytes.fetch_add(size, std::memory_order_relaxed) + size;
+	size_t peak = counters.peakBytes.load(std::memory_order_relaxed);
+	while (live > peak && !counters.peakBytes.compare_exchange_weak(peak, live, std::memory_order_relaxed));
 }
 
-void AllocatorTracker::deallocate(const void* const pointer, AllocatorMemoryType type, AllocatorCategory category)
+size_t AllocatorTracker::erase(AllocationMap& allocations, AllocationMap::iterator it, AllocatorMemoryType type, AllocatorCategory category)
 {
-	if (pointer == nullptr)
-		return;
-	AllocatorTrackingData& tracking = m_data[EnumToIndex(type)][EnumToIndex(category)];
-	auto it = tracking.m_allocations.find(pointer);
-	AKA_ASSERT(it != tracking.m_allocations.end(), "Missing allocation, or double deallocation");
-	AKA_ASSERT(tracking.m_memoryAllocated > tracking.m_memoryDeallocated, "Invalid deallocation");
-	AKA_ASSERT(tracking.m_allocation > tracking.m_deallocation, "Invalid deallocation");
 	const AllocationTrackingData& data = it->second;
 	//std::cout << "Deallocation for " << data.info->name() << " of " << data.count << " elements of size " << data.elementSize << " with alignment of " << data.alignment << std::endl;
-	tracking.m_memoryDeallocated += data.elementSize * data.count;
-	tracking.m_deallocation += 1;
+	const size_t size = data.elementSize * data.count;
+	allocations.erase(it);
+	Counters& counters = m_counters[EnumToIndex(type)][EnumToIndex(category)];
+	AKA_ASSERT(counters.liveBytes.load(std::memory_order_relaxed) >= size, "Invalid deallocation");
+	counters.deallocationCount.fetch_add(1, std::memory_order_relaxed);
+	counters.deallocatedBytes.fetch_add(size, std::memory_order_relaxed);
+	counters.liveBytes.fetch_sub(size, std::memory_order_relaxed);
+	return size;
+}
 
-	// Fill memory infos
-	auto itType = tracking.m_typeAllocations.find(data.info);
-	AKA_ASSERT(itType != tracking.m_typeAllocations.end(), "Failed to retrieve type info");
-	AllocatorTrackingData::TypeAllocationInfo& typeInfo = tracking.m_typeAllocations[data.info];
-	AKA_ASSERT(typeInfo.elementSize == data.elementSize, "Mismatching element size");
-	AKA_ASSERT(typeInfo.count >= data.count, "Removing too many elements");
-	AKA_ASSERT(typeInfo.uniqueAllocation > 0, "Removing too many elements");
-	typeInfo.count -= data.count;
-	typeInfo.uniqueAllocation--;
+size_t AllocatorTracker::deallocate(const void* const pointer, AllocatorMemoryType type, AllocatorCategory category)
+{
+	if (pointer == nullptr)
+		return 0;
+	Shard& shard = getShard(pointer);
+	std::lock_guard<std::mutex> lock(shard.mutex);
+	AllocationMap& allocations = shard.allocations[EnumToIndex(type)][EnumToIndex(category)];
+	auto it = allocations.find(pointer);
+	AKA_ASSERT(it != allocations.end(), "Missing allocation, or double deallocation");
+	if (it == allocations.end())
+		return 0;
+	return erase(allocations, it, type, category);
+}
 
-	// Erase allocation
-	tracking.m_allocations.erase(pointer);
+void AllocatorTracker::deallocateRange(const void* const begin, const void* const end, AllocatorMemoryType type, AllocatorCategory category)
+{
+	for (Shard& shard : m_shards)
+	{
+		std::lock_guard<std::mutex> lock(shard.mutex);
+		AllocationMap& allocations = shard.allocations[EnumToIndex(type)][EnumToIndex(category)];
+		auto it = allocations.lower_bound(begin);
+		while (it != allocations.end() && it->first < end)
+		{
+			auto current = it++; // Erase invalidate current iterator.
+			erase(allocations, current, type, category);
+		}
+	}
 }
 
-void AllocatorTracker::reallocate(const void* const pOriginal, const void* const pNew, AllocatorMemoryType type, AllocatorCategory category, const AllocationTrackingData& data)
+size_t AllocatorTracker::reallocate(const void* const pOriginal, const void* const pNew, AllocatorMemoryType type, AllocatorCategory category, const AllocationTrackingData& data)
 {
 	if (pNew == nullptr)
-		return;
-	if (pOriginal != nullptr)
-		deallocate(pOriginal, type, category);
+		return 0;
+	const size_t size = (pOriginal != nullptr) ? deallocate(pOriginal, type, category) : 0;
 	allocate(pNew, type, category, data);
+	return size;
 }
-size_t AllocatorTracker::getUsedMemory() const
+
+size_t AllocatorTracker::getAllocationSize(const void* const pointer, AllocatorMemoryType type, AllocatorCategory category) const
+{
+	if (pointer == nullptr)
+		return 0;
+	Shard& shard = getShard(pointer);
+	std::lock_guard<std::mutex> lock(shard.mutex);
+	const AllocationMap& allocations = shard.allocations[EnumToIndex(type)][EnumToIndex(category)];
+	auto it = allocations.find(pointer);
+	if (it == allocations.end())
+		return 0;
+	return it->second.elementSize * it->second.count;
+}
+
+AllocatorStats AllocatorTracker::getStats(AllocatorMemoryType _type, AllocatorCategory _category) const
+{
+	const Counters& counters = m_counters[EnumToIndex(_type)][EnumToIndex(_category)];
+	AllocatorStats stats;
+	stats.liveBytes = counters.liveBytes.load(std::memory_order_relaxed);
+	stats.peakBytes = counters.peakBytes.load(std::memory_order_relaxed);
+	stats.allocatedBytes = counters.allocatedBytes.load(std::memory_order_relaxed);
+	stats.deallocatedBytes = counters.deallocatedBytes.load(std::memory_order_relaxed);
+	stats.allocationCount = counters.allocationCount.load(std::memory_order_relaxed);
+	stats.deallocationCount = counters.deallocationCount.load(std::memory_order_relaxed);
+	for (size_t i = 0; i < AllocatorStats::HistogramBucketCount; i++)
+		stats.histogram[i] = counters.histogram[i].load(std::memory_order_relaxed);
+	return stats;
+}
+
+AllocatorStats AllocatorTracker::getStats(AllocatorMemoryType _type) const
+{
+	AllocatorStats stats;
+	for (AllocatorCategory category : EnumRange<AllocatorCategory>())
+		stats += getStats(_type, category);
+	return stats;
+}
+
+AllocatorStats AllocatorTracker::getStats(AllocatorCategory _category) const
+{
+	AllocatorStats stats;
+	for (AllocatorMemoryType type : EnumRange<AllocatorMemoryType>())
+		stats += getStats(type, _category);
+	return stats;
+}
+
+AllocatorStats AllocatorTracker::getStats() const
+{
+	AllocatorStats stats;
+	for (AllocatorMemoryType type : EnumRange<AllocatorMemoryType>())
+		stats += getStats(type);
+	return stats;
+}
+
+void AllocatorTracker::resetPeak()
 {
-	size_t used = 0;
 	for (AllocatorMemoryType type : EnumRange<AllocatorMemoryType>())
 	{
 		for (AllocatorCategory category : EnumRange<AllocatorCategory>())
 		{
-			used += getUsedMemory(type, category);
+			Counters& counters = m_counters[EnumToIndex(type)][EnumToIndex(category)];
+			counters.peakBytes.store(counters.liveBytes.load(std::memory_order_relaxed), std::memory_order_relaxed);
 		}
 	}
-	return used;
 }
-size_t AllocatorTracker::getUsedMemory(AllocatorMemoryType _type) const
+
+void AllocatorTracker::setCallStackSampling(uint32_t rate)
 {
-	size_t used = 0;
-	for (AllocatorCategory category : EnumRange<AllocatorCategory>())
+	m_callStackSampling.store(rate, std::memory_order_relaxed);
+}
+
+uint64_t AllocatorTracker::captureCallStack()
+{
+	const uint32_t rate = m_callStackSampling.load(std::memory_order_relaxed);
+	if (rate == 0)
+		return 0;
+	// Per thread counter so that sampling does not need synchronization.
+	static thread_local uint32_t s_allocationCount = 0;
+	if (++s_allocationCount < rate)
+		return 0;
+	s_allocationCount = 0;
+	// Skip this function & allocate.
+	const CallStack callStack = CallStack::capture(2);
+	const uint64_t hash = callStack.hash();
+	std::lock_guard<std::mutex> lock(m_callStackMutex);
+	m_callStacks.insert(std::make_pair(hash, callStack));
+	return hash;
+}
+
+void AllocatorTracker::setLeakReportPath(const char* path)
+{
+	AKA_ASSERT(path != nullptr, "Invalid path");
+	AKA_ASSERT(strlen(path) < sizeof(m_leakReportPath), "Path too long");
+	snprintf(m_leakReportPath, sizeof(m_leakReportPath), "%s", path);
+}
+
+using SnapshotKey = std::tuple<AllocatorMemoryType, AllocatorCategory, const std::type_info*, uint64_t>;
+using SnapshotMap = std::map<SnapshotKey, AllocatorSnapshot::Entry, std::less<SnapshotKey>, AllocatorTracker::malloc_allocator<std::pair<const SnapshotKey, AllocatorSnapshot::Entry>>>;
+
+static void accumulate(SnapshotMap& map, const AllocatorSnapshot::Entry& entry, int64_t sign)
+{
+	auto it = map.insert(std::make_pair(SnapshotKey(entry.type, entry.category, entry.info, entry.callStack), AllocatorSnapshot::Entry{ entry.type, entry.category, entry.info, entry.callStack, 0, 0 })).first;
+	it->second.count += sign * entry.count;
+	it->second.bytes += sign * entry.bytes;
+}
+
+AllocatorSnapshot AllocatorTracker::takeSnapshot() const
+{
+	SnapshotMap map;
+	for (Shard& shard : m_shards)
 	{
-		used += getUsedMemory(_type, category);
+		std::lock_guard<std::mutex> lock(shard.mutex);
+		for (AllocatorMemoryType type : EnumRange<AllocatorMemoryType>())
+		{
+			for (AllocatorCategory category : EnumRange<AllocatorCategory>())
+			{
+				for (const auto& alloc : shard.allocations[EnumToIndex(type)][EnumToIndex(category)])
+				{
+					const AllocationTrackingData& data = alloc.second;
+					accumulate(map, AllocatorSnapshot::Entry{ type, category, data.info, data.callStack, 1, static_cast<int64_t>(data.elementSize * data.count) }, 1);
+				}
+			}
+		}
 	}
-	return used;
+	AllocatorSnapshot snapshot;
+	snapshot.entries.reserve(map.size());
+	std::lock_guard<std::mutex> lock(m_callStackMutex);
+	for (const auto& pair : map)
+	{
+		snapshot.entries.push_back(pair.second);
+		if (pair.second.callStack != 0)
+		{
+			auto it = m_callStacks.find(pair.second.callStack);
+			if (it != m_callStacks.end())
+				snapshot.callStacks.insert(*it);
+		}
+	}
+	return snapshot;
+}
+
+AllocatorSnapshot AllocatorSnapshot::diff(const AllocatorSnapshot& before, const AllocatorSnapshot& after)
+{
+	SnapshotMap map;
+	for (const Entry& entry : after.entries)
+		accumulate(map, entry, 1);
+	for (const Entry& entry : before.entries)
+		accumulate(map, entry, -1);
+	AllocatorSnapshot snapshot;
+	for (const auto& pair : map)
+	{
+		const Entry& entry = pair.second;
+		if (entry.count == 0 && entry.bytes == 0)
+			continue;
+		snapshot.entries.push_back(entry);
+		if (entry.callStack == 0)
+			continue;
+		auto it = after.callStacks.find(entry.callStack);
+		if (it != after.callStacks.end())
+			snapshot.callStacks.insert(*it);
+		else if ((it = before.callStacks.find(entry.callStack)) != before.callStacks.end())
+			snapshot.callStacks.insert(*it);
+	}
+	return snapshot;
 }
-size_t AllocatorTracker::getUsedMemory(AllocatorMemoryType _type, AllocatorCategory _category) const
+
+// Write a json string, escaping special characters.
+static void writeJSONString(FILE* file, const char* str)
+{
+	fputc('"', file);
+	for (const char* c = str; *c != '\0'; c++)
+	{
+		if (*c == '"' || *c == '\\')
+			fprintf(file, "\\%c", *c);
+		else if (static_cast<unsigned char>(*c) < 0x20)
+			fprintf(file, "\\u%04x", static_cast<unsigned int>(static_cast<unsigned char>(*c)));
+		else
+			fputc(*c, file);
+	}
+	fputc('"', file);
+}
+
+bool AllocatorSnapshot::exportJSON(const char* path) const
+{
+	FILE* file = fopen(path, "w");
+	if (file == nullptr)
+		return false;
+	int64_t totalCount = 0;
+	int64_t totalBytes = 0;
+	for (const Entry& entry : entries)
+	{
+		totalCount += entry.count;
+		totalBytes += entry.bytes;
+	}
+	fprintf(file, "{\n\t\"count\": %lld,\n\t\"bytes\": %lld,\n\t\"allocations\": [", static_cast<long long>(totalCount), static_cast<long long>(totalBytes));
+	for (size_t i = 0; i < entries.size(); i++)
+	{
+		const Entry& entry = entries[i];
+		fprintf(file, "%s\n\t\t{ \"type\": ", i == 0 ? "" : ",");
+		writeJSONString(file, toString(entry.type));
+		fprintf(file, ", \"category\": ");
+		writeJSONString(file, toString(entry.category));
+		fprintf(file, ", \"element\": ");
+		writeJSONString(file, entry.info != nullptr ? entry.info->name() : "unknown");
+		fprintf(file, ", \"callStack\": \"%016llx\", \"count\": %lld, \"bytes\": %lld }", static_cast<unsigned long long>(entry.callStack), static_cast<long long>(entry.count), static_cast<long long>(entry.bytes));
+	}
+	fprintf(file, "\n\t],\n\t\"callStacks\": {");
+	bool first = true;
+	char symbol[512];
+	for (const auto& pair : callStacks)
+	{
+		const CallStack& callStack = pair.second;
+		fprintf(file, "%s\n\t\t\"%016llx\": [", first ? "" : ",", static_cast<unsigned long long>(pair.first));
+		for (uint32_t iFrame = 0; iFrame < callStack.depth; iFrame++)
+		{
+			CallStack::resolve(callStack.frames[iFrame], symbol, sizeof(symbol));
+			fprintf(file, "%s\n\t\t\t", iFrame == 0 ? "" : ",");
+			writeJSONString(file, symbol);
+		}
+		fprintf(file, "\n\t\t]");
+		first = false;
+	}
+	fprintf(file, "\n\t}\n}\n");
+	return fclose(file) == 0;
+}
+
+size_t AllocatorTracker::getUsedMemory() const
 {
-	return m_data[EnumToIndex(_type)][EnumToIndex(_category)].getUsedMemory();
+	return getUsedMemoryCounter().load(std::memory_order_relaxed) + sizeof(AllocatorTracker);
 }
 
 AllocatorTracker& getAllocatorTracker()
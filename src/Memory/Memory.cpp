@@ -3,7 +3,15 @@
 #include <Aka/Memory/Allocator/LinearAllocator.h>
 #include <Aka/Memory/Allocator/RingAllocator.h>
 #include <Aka/Memory/Allocator/DefaultAllocator.h>
+#include <Aka/Memory/ThreadLocalRegistry.h>
 #include <Aka/Core/Enum.h>
+#include <Aka/Core/Container/Vector.h>
+
+#if defined(AKA_PLATFORM_APPLE)
+#include <malloc/malloc.h>
+#elif !defined(AKA_PLATFORM_WINDOWS)
+#include <malloc.h>
+#endif
 
 namespace aka {
 
@@ -63,8 +71,7 @@ void* Memory::raw() const
 
 void* Memory::alloc(size_t size)
 {
-	// TODO request os memory with brk / mmap
-	// https://learn.microsoft.com/fr-fr/windows/win32/memory/comparing-memory-allocation-methods
+	// Large ranges that should be committed on demand can use VirtualMemory instead.
 	return ::malloc(size);
 }
 
@@ -100,8 +107,25 @@ void* Memory::reallocAligned(void* data, size_t alignment, size_t size)
 #if defined(AKA_PLATFORM_WINDOWS)
 	return _aligned_realloc(data, size, alignment);
 #else // POSIX
-	free(data); // No aligned realloc for POSIX
-	return aligned_alloc(alignment, size);
+	// No aligned realloc for POSIX, allocate new memory & copy old content.
+	if (data == nullptr)
+		return allocAlligned(alignment, size);
+	if (size == 0)
+	{
+		freeAligned(data);
+		return nullptr;
+	}
+	void* newData = allocAlligned(alignment, size);
+	if (newData == nullptr)
+		return nullptr; // Old memory is left untouched, as with realloc.
+#if defined(AKA_PLATFORM_APPLE)
+	const size_t oldSize = malloc_size(data);
+#else
+	const size_t oldSize = malloc_usable_size(data);
+#endif
+	Memory::copy(newData, data, oldSize < size ? oldSize : size);
+	freeAligned(data);
+	return newData;
 #endif
 }
 
@@ -147,6 +171,9 @@ using DefaultAllocatorType = DefaultAllocator;
 // There should be some memory manager running everyframe & updating all blocks.
 Allocator& getAllocator(AllocatorMemoryType memory, AllocatorCategory category)
 {
+	// Budgets are used by allocators until their destruction, so they must outlive them.
+	static AllocatorBudgets& budgets = getAllocatorBudgets();
+	AKA_UNUSED(budgets);
 	static DefaultAllocator GlobalMemoryAllocator("GlobalMemoryAllocator", AllocatorMemoryType::Raw, AllocatorCategory::Global);
 
 	static DefaultAllocatorType AllocatorType[EnumCount<AllocatorMemoryType>()][EnumCount<AllocatorCategory>()] = {
@@ -245,6 +272,34 @@ Allocator& getAllocator(AllocatorMemoryType memory, AllocatorCategory category)
 	return AllocatorType[EnumToIndex(memory)][EnumToIndex(category)];
 }
 
+// Registry of all frame arenas. Arenas of exited threads are kept & reused by new threads.
+static ThreadLocalRegistry<LinearAllocator>& getFrameAllocatorRegistry()
+{
+	// Construct default allocators first so that they outlive the registry.
+	getAllocator(AllocatorMemoryType::Raw, AllocatorCategory::Global);
+	static ThreadLocalRegistry<LinearAllocator> registry(
+		[]() -> LinearAllocator* {
+			return akaNew<LinearAllocator>(AllocatorMemoryType::Object, AllocatorCategory::Global,
+				"FrameMemoryAllocator", AllocatorMemoryType::Raw, AllocatorCategory::Global, &getAllocator(AllocatorMemoryType::Blob, AllocatorCategory::Global), static_cast<size_t>(1U << 20)
+			);
+		},
+		[](LinearAllocator* allocator) { akaDelete(allocator); },
+		[](LinearAllocator* allocator) { allocator->reset(); }
+	);
+	return registry;
+}
+
+LinearAllocator& getFrameAllocator()
+{
+	static thread_local ThreadLocalRegistryEntry<LinearAllocator> allocator(getFrameAllocatorRegistry());
+	return *allocator.get();
+}
+
+void resetFrameAllocators()
+{
+	getFrameAllocatorRegistry().forEach([](LinearAllocator* allocator) { allocator->reset(); });
+}
+
 }; // namespace mem
 }; // namespace aka
 
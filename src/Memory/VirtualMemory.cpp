@@ -0,0 +1,134 @@
+#include <Aka/Memory/VirtualMemory.h>
+
+#if defined(AKA_PLATFORM_WINDOWS)
+#define NOMINMAX
+#define WIN32_LEAN_AND_MEAN
+#include <Windows.h>
+#else // POSIX
+#include <sys/mman.h>
+#include <unistd.h>
+#include <stdio.h>
+#endif
+
+namespace aka {
+
+size_t VirtualMemory::getPageSize()
+{
+#if defined(AKA_PLATFORM_WINDOWS)
+	static const size_t pageSize = []() {
+		SYSTEM_INFO info;
+		GetSystemInfo(&info);
+		return static_cast<size_t>(info.dwPageSize);
+	}();
+#else // POSIX
+	static const size_t pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+#endif
+	return pageSize;
+}
+
+size_t VirtualMemory::getLargePageSize()
+{
+#if defined(AKA_PLATFORM_WINDOWS)
+	static const size_t largePageSize = static_cast<size_t>(GetLargePageMinimum());
+#elif defined(AKA_PLATFORM_LINUX)
+	static const size_t largePageSize = []() -> size_t {
+		// Default huge page size, as reported by the kernel.
+		FILE* file = fopen("/proc/meminfo", "r");
+		if (file == nullptr)
+			return 0;
+		char line[256];
+		size_t size = 0;
+		while (fgets(line, sizeof(line), file) != nullptr)
+		{
+			unsigned long kb = 0;
+			if (sscanf(line, "Hugepagesize: %lu kB", &kb) == 1)
+			{
+				size = static_cast<size_t>(kb) * 1024;
+				break;
+			}
+		}
+		fclose(file);
+		return size;
+	}();
+#else
+	static const size_t largePageSize = 0;
+#endif
+	return largePageSize;
+}
+
+void* VirtualMemory::reserve(size_t size)
+{
+#if defined(AKA_PLATFORM_WINDOWS)
+	return VirtualAlloc(nullptr, size, MEM_RESERVE, PAGE_NOACCESS);
+#else // POSIX
+	void* address = mmap(nullptr, size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+	return (address == MAP_FAILED) ? nullptr : address;
+#endif
+}
+
+bool VirtualMemory::commit(void* address, size_t size)
+{
+	AKA_ASSERT(reinterpret_cast<uintptr_t>(address) % getPageSize() == 0, "Address not aligned on page size");
+#if defined(AKA_PLATFORM_WINDOWS)
+	return VirtualAlloc(address, size, MEM_COMMIT, PAGE_READWRITE) != nullptr;
+#else // POSIX
+	// Physical pages are allocated by the kernel on first access.
+	return mprotect(address, size, PROT_READ | PROT_WRITE) == 0;
+#endif
+}
+
+bool VirtualMemory::decommit(void* address, size_t size)
+{
+	AKA_ASSERT(reinterpret_cast<uintptr_t>(address) % getPageSize() == 0, "Address not aligned on page size");
+#if defined(AKA_PLATFORM_WINDOWS)
+	return VirtualFree(address, size, MEM_DECOMMIT) != 0;
+#else // POSIX
+	// Remap range to drop its pages & keep it reserved.
+	void* result = mmap(address, size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE | MAP_FIXED, -1, 0);
+	return result != MAP_FAILED;
+#endif
+}
+
+void VirtualMemory::release(void* address, size_t size)
+{
+	if (address == nullptr)
+		return;
+#if defined(AKA_PLATFORM_WINDOWS)
+	AKA_UNUSED(size);
+	VirtualFree(address, 0, MEM_RELEASE);
+#else // POSIX
+	munmap(address, size);
+#endif
+}
+
+void* VirtualMemory::allocateLargePages(size_t size)
+{
+	const size_t largePageSize = getLargePageSize();
+	if (largePageSize == 0)
+		return nullptr;
+	AKA_ASSERT(size % largePageSize == 0, "Size not aligned on large page size");
+#if defined(AKA_PLATFORM_WINDOWS)
+	// Require SeLockMemoryPrivilege, large pages cannot be reserved without being committed.
+	return VirtualAlloc(nullptr, size, MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, PAGE_READWRITE);
+#elif defined(AKA_PLATFORM_LINUX)
+	void* address = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+	if (address != MAP_FAILED)
+		return address;
+	// No huge pages preallocated, fallback to transparent huge pages.
+	address = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	if (address == MAP_FAILED)
+		return nullptr;
+	madvise(address, size, MADV_HUGEPAGE);
+	return address;
+#else
+	return nullptr;
+#endif
+}
+
+size_t VirtualMemory::alignToPageSize(size_t size)
+{
+	const size_t pageSize = getPageSize();
+	return (size + pageSize - 1) / pageSize * pageSize;
+}
+
+};
@@ -0,0 +1,107 @@
+#include <Aka/OS/CallStack.h>
+
+#include <Aka/Core/Config.h>
+
+#include <stdio.h>
+#include <string.h>
+
+#if defined(AKA_PLATFORM_WINDOWS)
+#define NOMINMAX
+#define WIN32_LEAN_AND_MEAN
+#include <Windows.h>
+#include <DbgHelp.h>
+#include <mutex>
+#pragma comment(lib, "dbghelp.lib")
+#else // POSIX
+#include <execinfo.h>
+#include <dlfcn.h>
+#include <cxxabi.h>
+#include <stdlib.h>
+#endif
+
+namespace aka {
+
+CallStack CallStack::capture(uint32_t skip)
+{
+	CallStack callStack;
+#if defined(AKA_PLATFORM_WINDOWS)
+	callStack.depth = RtlCaptureStackBackTrace(skip + 1, MaxDepth, callStack.frames, nullptr);
+#else // POSIX
+	void* frames[MaxDepth + 8];
+	const int count = backtrace(frames, static_cast<int>(MaxDepth + 8));
+	const int first = static_cast<int>(skip) + 1; // Skip this function
+	callStack.depth = 0;
+	for (int i = first; i < count && callStack.depth < MaxDepth; i++)
+		callStack.frames[callStack.depth++] = frames[i];
+#endif
+	return callStack;
+}
+
+uint64_t CallStack::hash() const
+{
+	// FNV-1a on frame addresses
+	uint64_t hash = 14695981039346656037ULL;
+	for (uint32_t i = 0; i < depth; i++)
+	{
+		hash ^= static_cast<uint64_t>(reinterpret_cast<uintptr_t>(frames[i]));
+		hash *= 1099511628211ULL;
+	}
+	return hash;
+}
+
+void CallStack::resolve(const void* frame, char* buffer, size_t size)
+{
+	AKA_ASSERT(size > 0, "Empty buffer");
+#if defined(AKA_PLATFORM_WINDOWS)
+	// DbgHelp is single threaded.
+	static std::mutex s_mutex;
+	std::lock_guard<std::mutex> lock(s_mutex);
+	static const HANDLE process = []() {
+		HANDLE handle = GetCurrentProcess();
+		SymSetOptions(SYMOPT_UNDNAME | SYMOPT_DEFERRED_LOADS | SYMOPT_LOAD_LINES);
+		SymInitialize(handle, nullptr, TRUE);
+		return handle;
+	}();
+	const DWORD64 address = reinterpret_cast<DWORD64>(frame);
+	alignas(SYMBOL_INFO) char symbolBuffer[sizeof(SYMBOL_INFO) + MAX_SYM_NAME];
+	SYMBOL_INFO* symbol = reinterpret_cast<SYMBOL_INFO*>(symbolBuffer);
+	symbol->SizeOfStruct = sizeof(SYMBOL_INFO);
+	symbol->MaxNameLen = MAX_SYM_NAME;
+	DWORD64 displacement = 0;
+	if (!SymFromAddr(process, address, &displacement, symbol))
+	{
+		snprintf(buffer, size, "0x%llx", static_cast<unsigned long long>(address));
+		return;
+	}
+	IMAGEHLP_LINE64 line = {};
+	line.SizeOfStruct = sizeof(IMAGEHLP_LINE64);
+	DWORD lineDisplacement = 0;
+	if (SymGetLineFromAddr64(process, address, &lineDisplacement, &line))
+		snprintf(buffer, size, "%s (%s:%lu)", symbol->Name, line.FileName, static_cast<unsigned long>(line.LineNumber));
+	else
+		snprintf(buffer, size, "%s+0x%llx", symbol->Name, static_cast<unsigned long long>(displacement));
+#else // POSIX
+	Dl_info info;
+	if (dladdr(frame, &info) == 0)
+	{
+		snprintf(buffer, size, "%p", frame);
+		return;
+	}
+	if (info.dli_sname != nullptr)
+	{
+		int status = -1;
+		char* demangled = abi::__cxa_demangle(info.dli_sname, nullptr, nullptr, &status);
+		const uintptr_t offset = reinterpret_cast<uintptr_t>(frame) - reinterpret_cast<uintptr_t>(info.dli_saddr);
+		snprintf(buffer, size, "%s+0x%llx", (status == 0 && demangled != nullptr) ? demangled : info.dli_sname, static_cast<unsigned long long>(offset));
+		free(demangled);
+	}
+	else
+	{
+		// No exported symbol, give module offset to resolve it offline.
+		const uintptr_t offset = reinterpret_cast<uintptr_t>(frame) - reinterpret_cast<uintptr_t>(info.dli_fbase);
+		snprintf(buffer, size, "%s+0x%llx", info.dli_fname != nullptr ? info.dli_fname : "?", static_cast<unsigned long long>(offset));
+	}
+#endif
+}
+
+};
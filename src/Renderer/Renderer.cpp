@@ -382,7 +382,7 @@ void Renderer::render(gfx::FrameHandle frame)
 	}
 
 	gfx::SwapchainHandle swapchain = m_window->swapchain();
-	for (const std::pair<ViewHandle, View>& viewPair : m_views)
+	for (const std::pair<const ViewHandle, View>& viewPair : m_views)
 	{
 		const ViewHandle viewHandle = viewPair.first;
 		const View& view = viewPair.second;
@@ -15,6 +15,7 @@ namespace aka {
 AssetID generateAssetIDFromAssetPath(const AssetPath& path)
 {
 	// With an AssetID depending on path, moving this asset will break all references...
+	// AssetID are serialized, so it must stay on FNV & not follow the default hash backend.
 	return AssetID(aka::hash::fnv(path.cstr(), path.size()));
 }
 
@@ -15,15 +15,21 @@ Scene::Scene() :
 	Resource(ResourceType::Scene),
 	m_allocator(),
 	m_root(m_allocator.create("RootNode")),
-	m_mainCamera(nullptr)
+	m_mainCamera(nullptr),
+	m_scheduler(),
+	m_workerPool(nullptr)
 {
+	m_scheduler.build(m_allocator);
 }
 Scene::Scene(AssetID _id, const String& _name) :
 	Resource(ResourceType::Scene, _id, _name),
 	m_allocator(),
 	m_root(m_allocator.create("RootNode")),
-	m_mainCamera(nullptr)
+	m_mainCamera(nullptr),
+	m_scheduler(),
+	m_workerPool(nullptr)
 {
+	m_scheduler.build(m_allocator);
 }
 Scene::~Scene()
 {
@@ -38,7 +44,7 @@ void Scene::fromArchive_internal(ArchiveLoadContext& _context, Renderer* _render
 	for (const ArchiveSceneNode& node : scene.nodes)
 	{
 		Node* sceneNode = m_allocator.create(node.name.cstr());
-		sceneNode->setLocalTransform(node.transform, true);
+		sceneNode->setLocalTransform(node.transform, false); // Computed for all nodes at once after loading.
 		if (node.parentID != ArchiveSceneID::Invalid)
 		{
 			Node* parent = nodes[EnumToValue(node.parentID)];
@@ -61,6 +67,7 @@ void Scene::fromArchive_internal(ArchiveLoadContext& _context, Renderer* _render
 		}
 		nodes.append(sceneNode);
 	}
+	m_allocator.getTransforms().update();
 #if 0
 	auto recurseDebug = std::function<void(Node*, uint32_t)>();
 	recurseDebug = [&recurseDebug](Node* parent, uint32_t depth) {
@@ -111,9 +118,8 @@ void Scene::toArchive_internal(ArchiveSaveContext& _context, Renderer* _renderer
 		node.name = sceneNode->getName();
 		node.transform = sceneNode->getLocalTransform();
 		// Serialize component
-		for (auto pair : sceneNode->getComponentMap())
+		for (ComponentBase* component : sceneNode->getComponents())
 		{
-			ComponentBase* component = pair.second;
 			ArchiveComponent* archiveComponent = component->createArchiveBase();
 			component->toArchiveBase(*archiveComponent);
 			ArchiveSceneComponent archive;
@@ -143,39 +149,34 @@ void Scene::destroy_internal(AssetLibrary* _library, Renderer* _renderer)
 
 void Scene::update(Time _deltaTime)
 {
-	m_allocator.visitComponentPools([=](ComponentBase& _component) {
-		if (_component.getState() == ComponentState::Active)
-		{
-			_component.update(_deltaTime);
-		}
+	m_scheduler.run(SystemPhase::Update, m_workerPool, [=](ComponentBase& _component) {
+		_component.update(_deltaTime);
 	});
 }
 void Scene::fixedUpdate(Time _deltaTime)
 {
-	m_allocator.visitComponentPools([=](ComponentBase& _component) {
-		if (_component.getState() == ComponentState::Active)
-		{
-			_component.fixedUpdate(_deltaTime);
-		}
+	m_scheduler.run(SystemPhase::FixedUpdate, m_workerPool, [=](ComponentBase& _component) {
+		_component.fixedUpdate(_deltaTime);
 	});
 }
 void Scene::update(AssetLibrary* _library, Renderer* _renderer)
 {
+	// Propagate world transforms of moved nodes to their childs.
+	m_allocator.getTransforms().update();
 	// Activate & deactive required nodes & prepareUpdate
 	// TODO: node activation & deactivation could be done from pool instead.
 	m_allocator.visitNodes([=](Node& _node) {
 		_node.updateComponentLifecycle(_library, _renderer);
 		_node.prepareUpdate();
 	});
-	m_allocator.visitComponentPools([=](ComponentBase& _component) {
-		if (_component.getState() == ComponentState::Active)
-		{
-			_component.renderUpdate(_library, _renderer);
-		}
+	m_scheduler.run(SystemPhase::RenderUpdate, m_workerPool, [=](ComponentBase& _component) {
+		_component.renderUpdate(_library, _renderer);
 	});
 	m_allocator.visitNodes([](Node& _node) {
 		_node.finishUpdate();
 	});
+	m_allocator.getTransforms().clearUpdated();
+	m_allocator.nextFrame();
 }
 
 void Scene::setMainCameraNode(Node* parent)
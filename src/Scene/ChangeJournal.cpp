@@ -0,0 +1,46 @@
+#include <Aka/Scene/ChangeJournal.hpp>
+
+#include <algorithm>
+
+namespace aka {
+
+ChangeJournal::ChangeJournal() :
+	m_firstFrame(0)
+{
+}
+ChangeJournal::~ChangeJournal()
+{
+}
+
+void ChangeJournal::record(NodeHandle _node, ChangeType _type, uint32_t _frame)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	AKA_ASSERT(m_changes.size() == 0 || m_changes.last().frame <= _frame, "Changes should be recorded in frame order");
+	m_changes.append(ChangeEvent{ _node, _type, _frame });
+}
+
+void ChangeJournal::trim(uint32_t _frame)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	if (_frame <= m_firstFrame)
+		return;
+	ChangeEvent* first = std::lower_bound(m_changes.begin(), m_changes.end(), _frame, [](const ChangeEvent& _change, uint32_t _frame) {
+		return _change.frame < _frame;
+	});
+	if (first != m_changes.begin())
+		m_changes.remove(m_changes.begin(), first);
+	m_firstFrame = _frame;
+}
+
+ChangeRange ChangeJournal::getChanges(uint32_t _frame) const
+{
+	// Changes are ordered by frame.
+	const ChangeEvent* begin = m_changes.begin();
+	const ChangeEvent* end = m_changes.end();
+	const ChangeEvent* first = std::lower_bound(begin, end, _frame, [](const ChangeEvent& _change, uint32_t _frame) {
+		return _change.frame < _frame;
+	});
+	return ChangeRange(first, end, _frame >= m_firstFrame);
+}
+
+};
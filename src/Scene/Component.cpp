@@ -1,4 +1,5 @@
 #include <Aka/Scene/Component.hpp>
+#include <Aka/Scene/NodeAllocator.hpp>
 
 #include <Aka/Resource/AssetLibrary.hpp>
 #include <Aka/OS/Stream/MemoryStream.h>
@@ -27,6 +28,7 @@ void ArchiveComponent::save(Vector<byte_t>& byte)
 }
 
 ComponentBase::ComponentBase(Node* node, ComponentID componentID) :
+	m_dirty(false),
 	m_state(ComponentState::PendingActivation),
 	m_componentID(componentID),
 	m_node(node),
@@ -90,6 +92,15 @@ void ComponentBase::renderUpdate(AssetLibrary* library, Renderer* _renderer)
 	AKA_ASSERT(m_state == ComponentState::Active, "Invalid state");
 	onRenderUpdate(library, _renderer);
 }
+void ComponentBase::setDirty()
+{
+	m_dirty = true;
+	NodeAllocator& allocator = m_node->getAllocator();
+	ComponentAllocatorBase& components = allocator.getComponentAllocator(m_componentID);
+	// Detached components are not tracked anymore.
+	if (components.find(m_node->getHandle().index) == this)
+		components.setChanged(m_node->getHandle().index, allocator.getFrame());
+}
 void ComponentBase::registerForUpdates(ComponentUpdateFlags flags)
 {
 	m_updateFlags |= flags;
@@ -137,7 +137,8 @@ void RigidBodyComponent::onFixedUpdate(Time _deltaTime)
 {
 	// Dirty temp hack to simulate a system executing only once per frame.
 	// With this dirty hack, onFixedUpdate change local transform, but next fixed update, we get world transform that is not cached yet.
-	if (getNode()->getName() != "Sphere0")
+	static const StringID sphereName = getStringTable().intern("Sphere0");
+	if (getNode()->getNameID() != sphereName)
 		return;
 
 	// https://matthias-research.github.io/pages/publications/PBDBodies.pdf
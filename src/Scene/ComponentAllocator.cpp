@@ -1,9 +1,64 @@
 #include <Aka/Scene/ComponentAllocator.hpp>
+#include <Aka/Scene/Node.hpp>
 #include <Aka/Memory/Allocator.h>
 #include <Aka/Memory/AllocatorTracker.hpp>
 
 namespace aka {
 
+ComponentBase* ComponentAllocatorBase::find(uint32_t _nodeIndex) const
+{
+	if (_nodeIndex >= m_sparse.size())
+		return nullptr;
+	const uint32_t index = m_sparse[_nodeIndex];
+	return index == InvalidIndex ? nullptr : m_components[index];
+}
+void ComponentAllocatorBase::insert(uint32_t _nodeIndex, Node* _node, ComponentBase* _component, uint32_t _frame)
+{
+	if (_nodeIndex >= m_sparse.size())
+		m_sparse.resize(_nodeIndex + 1, InvalidIndex);
+	AKA_ASSERT(m_sparse[_nodeIndex] == InvalidIndex, "Component already attached to node");
+	m_sparse[_nodeIndex] = static_cast<uint32_t>(m_components.size());
+	m_components.append(_component);
+	m_nodes.append(_node);
+	m_changedFrames.append(_frame);
+	m_journal.record(_node->getHandle(), ChangeType::Added, _frame);
+}
+void ComponentAllocatorBase::erase(uint32_t _nodeIndex, uint32_t _frame)
+{
+	AKA_ASSERT(_nodeIndex < m_sparse.size() && m_sparse[_nodeIndex] != InvalidIndex, "Component not attached to node");
+	// Move last component in the hole to keep them packed.
+	const uint32_t index = m_sparse[_nodeIndex];
+	m_journal.record(m_nodes[index]->getHandle(), ChangeType::Removed, _frame);
+	const uint32_t lastIndex = static_cast<uint32_t>(m_components.size() - 1);
+	if (index != lastIndex)
+	{
+		m_components[index] = m_components[lastIndex];
+		m_nodes[index] = m_nodes[lastIndex];
+		m_changedFrames[index] = m_changedFrames[lastIndex];
+		m_sparse[m_nodes[index]->getHandle().index] = index;
+	}
+	m_components.remove(&m_components.last());
+	m_nodes.remove(&m_nodes.last());
+	m_changedFrames.remove(&m_changedFrames.last());
+	m_sparse[_nodeIndex] = InvalidIndex;
+}
+void ComponentAllocatorBase::setChanged(uint32_t _nodeIndex, uint32_t _frame)
+{
+	AKA_ASSERT(_nodeIndex < m_sparse.size() && m_sparse[_nodeIndex] != InvalidIndex, "Component not attached to node");
+	const uint32_t index = m_sparse[_nodeIndex];
+	// Only journal first change of a frame, added components are already recorded.
+	if (m_changedFrames[index] != _frame)
+	{
+		m_changedFrames[index] = _frame;
+		m_journal.record(m_nodes[index]->getHandle(), ChangeType::Modified, _frame);
+	}
+}
+uint32_t ComponentAllocatorBase::getChangedFrame(uint32_t _nodeIndex) const
+{
+	AKA_ASSERT(_nodeIndex < m_sparse.size() && m_sparse[_nodeIndex] != InvalidIndex, "Component not attached to node");
+	return m_changedFrames[m_sparse[_nodeIndex]];
+}
+
 ComponentAllocatorMap::ComponentAllocatorMap(Allocator& _allocator) :
 	m_allocator(_allocator)
 {
@@ -47,8 +102,15 @@ void ComponentAllocatorMap::add(ComponentID _componentID, ComponentAllocatorBase
 }
 ComponentAllocatorBase* ComponentAllocatorMap::get(ComponentID _componentID)
 {
-	AKA_ASSERT(m_container.find(_componentID) != m_container.end(), "Component does not exist");
-	return m_container[_componentID];
+	auto it = m_container.find(_componentID);
+	AKA_ASSERT(it != m_container.end(), "Component does not exist");
+	return it->second;
+}
+const ComponentAllocatorBase* ComponentAllocatorMap::get(ComponentID _componentID) const
+{
+	auto it = m_container.find(_componentID);
+	AKA_ASSERT(it != m_container.end(), "Component does not exist");
+	return it->second;
 }
 void ComponentAllocatorMap::visit(std::function<void(ComponentAllocatorBase*)> _callback)
 {
@@ -7,36 +7,75 @@ namespace aka {
 
 Node::Node(NodeAllocator* _allocator) :
 	m_parent(nullptr),
-	m_name("Unknown"),
+	m_transform(_allocator->getTransforms().create()),
+	m_name(getStringTable().intern("Unknown")),
 	m_allocator(_allocator),
-	m_updateFlags(NodeUpdateFlag::None),
-	m_localTransform(mat4f::identity()),
-	m_cacheWorldTransform(mat4f::identity())
+	m_handle(NodeHandle::null),
+	m_updateFlags(NodeUpdateFlag::None)
 {
 }
 Node::Node(const char* name, NodeAllocator* _allocator) :
 	m_parent(nullptr),
-	m_name(name),
+	m_transform(_allocator->getTransforms().create()),
+	m_name(getStringTable().intern(name)),
 	m_allocator(_allocator),
-	m_updateFlags(NodeUpdateFlag::None),
-	m_localTransform(mat4f::identity()),
-	m_cacheWorldTransform(mat4f::identity())
+	m_handle(NodeHandle::null),
+	m_updateFlags(NodeUpdateFlag::None)
 {
 }
 Node::~Node()
 {
-	AKA_ASSERT(m_componentsToActivate.size() == 0, "Missing components");
-	AKA_ASSERT(m_componentsActive.size() == 0, "Missing components");
+	AKA_ASSERT(m_components.size() == 0, "Missing components");
 	AKA_ASSERT(m_componentsToDeactivate.size() == 0, "Missing components");
+	m_allocator->getTransforms().destroy(m_transform);
+}
+
+ComponentBase* Node::allocateComponent(ComponentID componentID)
+{
+	return m_allocator->allocate(componentID, this);
 }
 
 void Node::attach(ComponentBase* component)
 {
 	const ComponentID id = component->getComponentID();
-	AKA_ASSERT(m_componentIDs.find(id) == m_componentIDs.end(), "Trying to attach non attached component");
-	m_componentIDs.insert(id);
+	AKA_ASSERT(findComponent(id) == nullptr, "Trying to attach already attached component");
+	m_allocator->getComponentAllocator(id).insert(m_handle.index, this, component, m_allocator->getFrame());
+	m_components.append(component);
 	component->onAttach();
-	m_componentsToActivate.insert(std::make_pair(id, component));
+	m_componentsToActivate.append(component);
+}
+
+void Node::detach(ComponentID componentID)
+{
+	ComponentBase* component = findComponent(componentID);
+	AKA_ASSERT(component != nullptr, "Trying to detach non attached component");
+	m_allocator->getComponentAllocator(componentID).erase(m_handle.index, m_allocator->getFrame());
+	m_components.remove(std::find(m_components.begin(), m_components.end(), component));
+	ComponentBase** toActivate = std::find(m_componentsToActivate.begin(), m_componentsToActivate.end(), component);
+	if (toActivate != m_componentsToActivate.end())
+		m_componentsToActivate.remove(toActivate);
+	// Component still active until deactivate was call on it.
+	m_componentsToDeactivate.append(component);
+}
+
+ComponentBase* Node::findComponent(ComponentID componentID)
+{
+	return m_allocator->getComponentAllocator(componentID).find(m_handle.index);
+}
+
+const ComponentBase* Node::findComponent(ComponentID componentID) const
+{
+	return m_allocator->getComponentAllocator(componentID).find(m_handle.index);
+}
+
+bool Node::isOrphan() const
+{
+	for (const ComponentBase* component : m_components)
+	{
+		if (component->getState() == ComponentState::Active)
+			return false;
+	}
+	return true;
 }
 
 void Node::create(AssetLibrary* library, Renderer* renderer)
@@ -56,26 +95,20 @@ void Node::destroy(AssetLibrary* library, Renderer* renderer)
 		childrens->destroy(library, renderer);
 	}
 	// Destroy components
-	for (std::pair<ComponentID, ComponentBase*> component : m_componentsToActivate)
-	{
-		component.second->detach();
-		m_allocator->deallocate(component.second);
-	}
-	for (std::pair<ComponentID, ComponentBase*> component : m_componentsActive)
+	for (ComponentBase* component : m_components)
 	{
-		component.second->deactivate(library, renderer);
-		component.second->detach();
-		m_allocator->deallocate(component.second);
+		m_allocator->getComponentAllocator(component->getComponentID()).erase(m_handle.index, m_allocator->getFrame());
+		m_componentsToDeactivate.append(component);
 	}
-	for (std::pair<ComponentID, ComponentBase*> component : m_componentsToDeactivate)
+	for (ComponentBase* component : m_componentsToDeactivate)
 	{
-		component.second->deactivate(library, renderer);
-		component.second->detach();
-		m_allocator->deallocate(component.second);
+		if (component->getState() == ComponentState::Active)
+			component->deactivate(library, renderer);
+		component->detach();
+		m_allocator->deallocate(component);
 	}
-	m_componentIDs.clear();
+	m_components.clear();
 	m_componentsToActivate.clear();
-	m_componentsActive.clear();
 	m_componentsToDeactivate.clear();
 }
 
@@ -83,18 +116,18 @@ void Node::updateComponentLifecycle(AssetLibrary* library, Renderer* renderer)
 {
 	{ // Components lifecycle.
 		// Activate components
-		for (std::pair<ComponentID, ComponentBase*> component : m_componentsToActivate)
+		for (ComponentBase* component : m_componentsToActivate)
 		{
-			component.second->activate(library, renderer);
-			m_componentsActive.insert(component);
+			component->activate(library, renderer);
 		}
 		m_componentsToActivate.clear();
 		// Deactivate components
-		for (std::pair<ComponentID, ComponentBase*> component : m_componentsToDeactivate)
+		for (ComponentBase* component : m_componentsToDeactivate)
 		{
-			component.second->deactivate(library, renderer);
-			component.second->detach();
-			m_allocator->deallocate(component.second);
+			if (component->getState() == ComponentState::Active)
+				component->deactivate(library, renderer);
+			component->detach();
+			m_allocator->deallocate(component);
 		}
 		m_componentsToDeactivate.clear();
 	}
@@ -102,24 +135,23 @@ void Node::updateComponentLifecycle(AssetLibrary* library, Renderer* renderer)
 
 void Node::prepareUpdate()
 {
-	if (asBool(NodeUpdateFlag::TransformDirty & m_updateFlags))
+	// World transforms were propagated by the hierarchy before.
+	if (m_allocator->getTransforms().isUpdated(m_transform))
 	{
-		m_cacheWorldTransform = computeWorldTransform();
-		m_updateFlags &= ~NodeUpdateFlag::TransformDirty;
-		visitAllChildrens([this](Node* node) {
-			node->m_cacheWorldTransform = node->computeWorldTransform();
-		});
-		for (ComponentMap::value_type& component : m_componentsActive)
+		m_updateFlags |= NodeUpdateFlag::TransformUpdated;
+		m_allocator->getTransformJournal().record(m_handle, ChangeType::TransformUpdated, m_allocator->getFrame());
+		for (ComponentBase* component : m_components)
 		{
-			component.second->transformUpdate();
+			if (component->getState() == ComponentState::Active)
+				component->transformUpdate();
 		}
 	}
 	else if (asBool(NodeUpdateFlag::HierarchyUpdated & m_updateFlags))
 	{
-		m_cacheWorldTransform = computeWorldTransform();
-		for (ComponentMap::value_type& component : m_componentsActive)
+		for (ComponentBase* component : m_components)
 		{
-			component.second->hierarchyUpdate();
+			if (component->getState() == ComponentState::Active)
+				component->hierarchyUpdate();
 		}
 	}
 }
@@ -138,7 +170,9 @@ void Node::unlink()
 	parent->removeChild(this);
 	for (Node* child : m_childrens)
 	{
+		child->m_parent = parent;
 		parent->m_childrens.append(child);
+		m_allocator->getTransforms().setParent(child->m_transform, parent->m_transform);
 	}
 	m_childrens.clear();
 }
@@ -150,6 +184,7 @@ void Node::addChild(Node* child)
 	AKA_ASSERT(child->m_parent == nullptr, "Child already have a parent");
 	child->m_parent = this;
 	m_childrens.append(child);
+	m_allocator->getTransforms().setParent(child->m_transform, m_transform);
 }
 void Node::removeChild(Node* child)
 {
@@ -160,6 +195,7 @@ void Node::removeChild(Node* child)
 	{
 		m_childrens.remove(it);
 		child->m_parent = nullptr;
+		m_allocator->getTransforms().setParent(child->m_transform, TransformID::Invalid);
 	}
 	else
 	{
@@ -168,11 +204,12 @@ void Node::removeChild(Node* child)
 }
 void Node::setParent(Node* parent)
 {
-	setUpdateFlag(NodeUpdateFlag::HierarchyUpdated | NodeUpdateFlag::TransformUpdated | NodeUpdateFlag::TransformDirty);
+	setUpdateFlag(NodeUpdateFlag::HierarchyUpdated | NodeUpdateFlag::TransformUpdated);
 	if (m_parent)
 		m_parent->removeChild(this);
 	m_parent = parent;
 	m_parent->m_childrens.append(this);
+	m_allocator->getTransforms().setParent(m_transform, parent->m_transform);
 }
 Node* Node::getParent()
 {
@@ -214,12 +251,12 @@ void Node::visitAllChildrens(std::function<void(Node*)> _callback)
 
 const mat4f& Node::getLocalTransform() const
 {
-	return m_localTransform;
+	return m_allocator->getTransforms().getLocal(m_transform);
 }
 const mat4f& Node::getWorldTransform() const
 {
-	AKA_ASSERT(!asBool(NodeUpdateFlag::TransformDirty & m_updateFlags), "Getting dirty world transform. Should call computeWorldTransform instead here as it was updated and not cached yet.");
-	return m_cacheWorldTransform;
+	AKA_ASSERT(!m_allocator->getTransforms().isDirty(m_transform), "Getting dirty world transform. Should set local transform with _computeWorld or wait for scene update.");
+	return m_allocator->getTransforms().getWorld(m_transform);
 }
 mat4f Node::getParentTransform() const
 {
@@ -229,30 +266,23 @@ mat4f Node::getParentTransform() const
 }
 void Node::setLocalTransform(const mat4f& _transform, bool _computeWorld)
 {
-	m_localTransform = _transform;
-	if (_computeWorld)
+	TransformHierarchy& transforms = m_allocator->getTransforms();
+	transforms.setLocal(m_transform, _transform);
+	// Refresh the subtree now, parents first. Otherwise mark it dirty until next scene update.
+	SmallVector<Node*, 32> stack;
+	stack.append(this);
+	while (!stack.empty())
 	{
-		m_cacheWorldTransform = computeWorldTransform();
-		visitAllChildrens([this](Node* node) {
-			node->m_cacheWorldTransform = node->computeWorldTransform();
-			node->setUpdateFlag(NodeUpdateFlag::TransformUpdated);
-		});
-		setUpdateFlag(NodeUpdateFlag::TransformUpdated);
+		Node* node = stack.last();
+		stack.remove(&stack.last());
+		if (_computeWorld)
+			transforms.computeWorld(node->m_transform);
+		else
+			transforms.setDirty(node->m_transform);
+		node->m_updateFlags |= NodeUpdateFlag::TransformUpdated;
+		for (Node* child : node->m_childrens)
+			stack.append(child);
 	}
-	else
-	{
-		// Delay update.
-		setUpdateFlag(NodeUpdateFlag::TransformUpdated | NodeUpdateFlag::TransformDirty);
-		visitAllChildrens([this](Node* node) {
-			node->setUpdateFlag(NodeUpdateFlag::TransformUpdated | NodeUpdateFlag::TransformDirty);
-		});
-	}
-}
-mat4f Node::computeWorldTransform() const
-{
-	if (getParent())
-		return getParent()->computeWorldTransform() * m_localTransform;
-	return m_localTransform;
 }
 
 void Node::setUpdateFlag(NodeUpdateFlag flag, bool recurse)
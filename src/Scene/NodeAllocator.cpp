@@ -4,15 +4,21 @@
 
 namespace aka {
 
+// Enough for consumers updated every few frames, older ones need to resync.
+static constexpr uint32_t DefaultChangeHistory = 8;
+
 NodeAllocator::NodeAllocator() :
 	m_nodePool(),
-	m_componentMap(getDefaultComponentAllocators())
+	m_componentMap(getDefaultComponentAllocators()),
+	m_frame(1),
+	m_changeHistory(DefaultChangeHistory)
 {
 }
 NodeAllocator::~NodeAllocator()
 {
 	AKA_ASSERT(m_nodePool.count() == 0, "Node destroy missing");
 	m_nodePool.release([this](Node& node) { Logger::warn(node.getName(), " was not destroyed"); });
+	m_nodeHandles.clear();
 }
 ComponentBase* NodeAllocator::allocate(ComponentID _componentID, Node* _node)
 {
@@ -24,20 +30,73 @@ void NodeAllocator::deallocate(ComponentBase* _component)
 	AKA_ASSERT(_component->getComponentID() == allocator->getComponentID(), "Invalid component type");
 	return allocator->deallocateBase(_component);
 }
+void NodeAllocator::nextFrame()
+{
+	m_frame++;
+	if (m_frame <= m_changeHistory)
+		return;
+	const uint32_t firstFrame = m_frame - m_changeHistory;
+	m_transformJournal.trim(firstFrame);
+	m_componentMap.visit([firstFrame](ComponentAllocatorBase* _componentAllocator) {
+		_componentAllocator->getJournal().trim(firstFrame);
+	});
+}
 Node* NodeAllocator::create(const char* _name)
 {
-	return m_nodePool.acquire(_name, this);
+	Node* node = m_nodePool.acquire(_name, this);
+	node->m_handle = m_nodeHandles.insert(node);
+	return node;
 }
 void NodeAllocator::destroy(Node* _node)
 {
+	const bool erased = m_nodeHandles.erase(_node->m_handle);
+	AKA_UNUSED(erased);
+	AKA_ASSERT(erased, "Node already destroyed");
 	return m_nodePool.release(_node);
 }
+Node* NodeAllocator::get(NodeHandle _handle)
+{
+	Node** node = m_nodeHandles.get(_handle);
+	return node == nullptr ? nullptr : *node;
+}
+bool NodeAllocator::isValid(NodeHandle _handle) const
+{
+	return m_nodeHandles.isValid(_handle);
+}
 void NodeAllocator::visitNodes(std::function<void(Node&)> _callback) {
 	for (Node& node : m_nodePool)
 	{
 		_callback(node);
 	}
 }
+void NodeAllocator::visitNodes(const ComponentID* _componentIDs, size_t _count, std::function<void(Node&)> _callback)
+{
+	if (_count == 0)
+		return visitNodes(_callback);
+	// Iterate the smallest set & check the others.
+	const ComponentAllocatorBase* smallest = &getComponentAllocator(_componentIDs[0]);
+	for (size_t i = 1; i < _count; i++)
+	{
+		const ComponentAllocatorBase* allocator = &getComponentAllocator(_componentIDs[i]);
+		if (allocator->count() < smallest->count())
+			smallest = allocator;
+	}
+	Node* const* nodes = smallest->getNodes();
+	for (size_t iNode = 0; iNode < smallest->count(); iNode++)
+	{
+		Node* node = nodes[iNode];
+		bool match = true;
+		for (size_t i = 0; i < _count && match; i++)
+			match = node->findComponent(_componentIDs[i]) != nullptr;
+		if (match)
+			_callback(*node);
+	}
+}
+void NodeAllocator::visitComponentAllocators(std::function<void(ComponentAllocatorBase&)> _callback) {
+	m_componentMap.visit([=](ComponentAllocatorBase* _componentAllocator) {
+		_callback(*_componentAllocator);
+		});
+}
 void NodeAllocator::visitComponentPools(std::function<void(ComponentBase&)> _callback) {
 	m_componentMap.visit([=](ComponentAllocatorBase* _componentAllocator) {
 		_componentAllocator->visitPool([=](ComponentBase& _component) {
@@ -0,0 +1,89 @@
+#include <Aka/Scene/SystemAccess.hpp>
+
+#include <algorithm>
+
+namespace aka {
+
+// Check if a component type is in a list
+static bool contains(const SmallVector<ComponentID, 4>& _componentIDs, ComponentID _componentID)
+{
+	return std::find(_componentIDs.begin(), _componentIDs.end(), _componentID) != _componentIDs.end();
+}
+// Check if a component type is written by a system, which always write its own type.
+static bool isWritten(ComponentID _systemID, const SystemAccess& _access, ComponentID _componentID)
+{
+	return _systemID == _componentID || contains(_access.writes, _componentID);
+}
+// Check if a component type is read or written by a system
+static bool isAccessed(ComponentID _systemID, const SystemAccess& _access, ComponentID _componentID)
+{
+	return isWritten(_systemID, _access, _componentID) || contains(_access.reads, _componentID);
+}
+// Check if a system write data accessed by another one
+static bool writeAccessed(ComponentID _componentID, const SystemAccess& _access, ComponentID _otherComponentID, const SystemAccess& _otherAccess)
+{
+	if (asBool(_access.writeResources & (_otherAccess.readResources | _otherAccess.writeResources)))
+		return true;
+	if (isAccessed(_otherComponentID, _otherAccess, _componentID))
+		return true;
+	for (ComponentID componentID : _access.writes)
+	{
+		if (isAccessed(_otherComponentID, _otherAccess, componentID))
+			return true;
+	}
+	return false;
+}
+
+SystemAccess::SystemAccess() :
+	reads(),
+	writes(),
+	readResources(SystemResource::None),
+	writeResources(SystemResource::None),
+	exclusive(false),
+	concurrent(false)
+{
+}
+
+SystemAccess SystemAccess::all()
+{
+	SystemAccess access;
+	access.exclusive = true;
+	return access;
+}
+
+SystemAccess& SystemAccess::read(ComponentID _componentID)
+{
+	if (!contains(reads, _componentID))
+		reads.append(_componentID);
+	return *this;
+}
+SystemAccess& SystemAccess::write(ComponentID _componentID)
+{
+	if (!contains(writes, _componentID))
+		writes.append(_componentID);
+	return *this;
+}
+SystemAccess& SystemAccess::read(SystemResource _resources)
+{
+	readResources |= _resources;
+	return *this;
+}
+SystemAccess& SystemAccess::write(SystemResource _resources)
+{
+	writeResources |= _resources;
+	return *this;
+}
+SystemAccess& SystemAccess::parallel()
+{
+	concurrent = true;
+	return *this;
+}
+
+bool SystemAccess::conflicts(ComponentID _componentID, const SystemAccess& _access, ComponentID _otherComponentID, const SystemAccess& _otherAccess)
+{
+	if (_access.exclusive || _otherAccess.exclusive)
+		return true;
+	return writeAccessed(_componentID, _access, _otherComponentID, _otherAccess) || writeAccessed(_otherComponentID, _otherAccess, _componentID, _access);
+}
+
+};
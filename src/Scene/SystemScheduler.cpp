@@ -0,0 +1,144 @@
+#include <Aka/Scene/SystemScheduler.hpp>
+
+#include <Aka/Scene/Component.hpp>
+#include <Aka/Scene/NodeAllocator.hpp>
+#include <Aka/Core/Worker/Parallel.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+namespace aka {
+
+// Minimum number of components per job for concurrent systems, as updates are usually small.
+static constexpr size_t SystemGrainSize = 64;
+
+// Get current time in microseconds
+static uint64_t getSystemTime()
+{
+	using namespace std::chrono;
+	return static_cast<uint64_t>(duration_cast<microseconds>(steady_clock::now().time_since_epoch()).count());
+}
+
+SystemScheduler::SystemScheduler()
+{
+}
+SystemScheduler::~SystemScheduler()
+{
+}
+
+void SystemScheduler::build(NodeAllocator& _allocator)
+{
+	m_systems.clear();
+	m_waves.clear();
+	_allocator.visitComponentAllocators([this](ComponentAllocatorBase& _components) {
+		System system;
+		system.components = &_components;
+		system.access = _components.getSystemAccess();
+		system.timing.name = _components.getName();
+		system.timing.componentID = _components.getComponentID();
+		system.timing.wave = 0;
+		for (uint64_t& time : system.timing.time)
+			time = 0;
+		m_systems.append(std::move(system));
+	});
+	// Allocator map order is not stable, so order by name.
+	std::sort(m_systems.begin(), m_systems.end(), [](const System& _lhs, const System& _rhs) {
+		const int order = std::strcmp(_lhs.timing.name, _rhs.timing.name);
+		return order < 0 || (order == 0 && _lhs.timing.componentID < _rhs.timing.componentID);
+	});
+	// A system run in the wave after every previous system it conflicts with.
+	uint32_t waveCount = 0;
+	for (size_t iSystem = 0; iSystem < m_systems.size(); iSystem++)
+	{
+		System& system = m_systems[iSystem];
+		for (size_t iPrevious = 0; iPrevious < iSystem; iPrevious++)
+		{
+			const System& previous = m_systems[iPrevious];
+			if (SystemAccess::conflicts(system.timing.componentID, system.access, previous.timing.componentID, previous.access))
+				system.timing.wave = max(system.timing.wave, previous.timing.wave + 1);
+		}
+		waveCount = max(waveCount, system.timing.wave + 1);
+	}
+	std::stable_sort(m_systems.begin(), m_systems.end(), [](const System& _lhs, const System& _rhs) {
+		return _lhs.timing.wave < _rhs.timing.wave;
+	});
+	m_waves.resize(waveCount + 1, 0);
+	for (const System& system : m_systems)
+		m_waves[system.timing.wave + 1]++;
+	for (uint32_t iWave = 0; iWave < waveCount; iWave++)
+		m_waves[iWave + 1] += m_waves[iWave];
+}
+
+void SystemScheduler::run(SystemPhase _phase, WorkerPool* _pool, UpdateFunc _func, void* _userData)
+{
+	const uint32_t phase = EnumToIndex(_phase);
+	for (System& system : m_systems)
+		system.timing.time[phase] = 0;
+	for (size_t iWave = 0; iWave < getWaveCount(); iWave++)
+	{
+		m_tasks.clear();
+		for (uint32_t iSystem = m_waves[iWave]; iSystem < m_waves[iWave + 1]; iSystem++)
+		{
+			System& system = m_systems[iSystem];
+			const size_t count = system.components->count();
+			if (count == 0)
+				continue;
+			const size_t chunkSize = (_pool != nullptr && system.access.concurrent) ? max<size_t>(getParallelGrainSize(*_pool, count, 0), SystemGrainSize) : count;
+			for (size_t begin = 0; begin < count; begin += chunkSize)
+				m_tasks.append(Task{ &system, begin, min<size_t>(begin + chunkSize, count), 0 });
+		}
+		if (_pool == nullptr || m_tasks.size() <= 1)
+		{
+			for (Task& task : m_tasks)
+				execute(task, _func, _userData);
+		}
+		else
+		{
+			// Tasks are not moved until the wave is done, calling thread take part.
+			JobCounter counter;
+			for (size_t iTask = 1; iTask < m_tasks.size(); iTask++)
+			{
+				Task* task = &m_tasks[iTask];
+				_pool->run(_pool->createJob<LambdaJob>([task, _func, _userData]() {
+					execute(*task, _func, _userData);
+				}), &counter);
+			}
+			execute(m_tasks[0], _func, _userData);
+			_pool->wait(counter);
+		}
+		for (const Task& task : m_tasks)
+			task.system->timing.time[phase] += task.time;
+	}
+}
+
+void SystemScheduler::execute(Task& _task, UpdateFunc _func, void* _userData)
+{
+	const uint64_t start = getSystemTime();
+	System& system = *_task.system;
+	const ComponentAllocatorBase* components = system.components;
+	if (system.access.exclusive)
+	{
+		// Detaching a component move the last one in its slot, so iterate over a copy.
+		// Components detached by previous updates are skipped.
+		system.snapshot.clear();
+		system.snapshot.append(components->getComponents() + _task.begin, components->getComponents() + _task.end);
+		for (ComponentBase* component : system.snapshot)
+		{
+			if (components->find(component->getNode()->getHandle().index) == component && component->getState() == ComponentState::Active)
+				_func(*component, _userData);
+		}
+	}
+	else
+	{
+		for (size_t i = _task.begin; i < _task.end; i++)
+		{
+			ComponentBase* component = components->getComponents()[i];
+			if (component->getState() == ComponentState::Active)
+				_func(*component, _userData);
+		}
+	}
+	_task.time = getSystemTime() - start;
+}
+
+};
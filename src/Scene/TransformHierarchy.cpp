@@ -0,0 +1,286 @@
+#include <Aka/Scene/TransformHierarchy.hpp>
+
+#include <Aka/Core/Worker/Parallel.h>
+#include <Aka/Core/Container/SmallVector.h>
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#define AKA_TRANSFORM_SSE
+#include <xmmintrin.h>
+#endif
+
+namespace aka {
+
+// Minimum number of transforms per job, smaller levels are computed by the calling thread.
+static constexpr size_t TransformGrainSize = 256;
+
+// Compute out = a * b for column major matrices.
+static inline void multiply(const mat4f& a, const mat4f& b, mat4f& out)
+{
+#if defined(AKA_TRANSFORM_SSE)
+	const __m128 a0 = _mm_loadu_ps(&a.cols[0][0]);
+	const __m128 a1 = _mm_loadu_ps(&a.cols[1][0]);
+	const __m128 a2 = _mm_loadu_ps(&a.cols[2][0]);
+	const __m128 a3 = _mm_loadu_ps(&a.cols[3][0]);
+	for (uint32_t i = 0; i < 4; i++)
+	{
+		__m128 column = _mm_mul_ps(a0, _mm_set1_ps(b.cols[i][0]));
+		column = _mm_add_ps(column, _mm_mul_ps(a1, _mm_set1_ps(b.cols[i][1])));
+		column = _mm_add_ps(column, _mm_mul_ps(a2, _mm_set1_ps(b.cols[i][2])));
+		column = _mm_add_ps(column, _mm_mul_ps(a3, _mm_set1_ps(b.cols[i][3])));
+		_mm_storeu_ps(&out.cols[i][0], column);
+	}
+#else
+	out = a * b;
+#endif
+}
+
+TransformHierarchy::TransformHierarchy() :
+	m_orderDirty(false)
+{
+	m_levels.append(0);
+}
+TransformHierarchy::~TransformHierarchy()
+{
+}
+
+TransformID TransformHierarchy::create()
+{
+	TransformID id;
+	if (m_freeIDs.size() > 0)
+	{
+		id = m_freeIDs.last();
+		m_freeIDs.remove(&m_freeIDs.last());
+	}
+	else
+	{
+		id = static_cast<TransformID>(m_indices.size());
+		m_indices.append(InvalidIndex);
+	}
+	const uint32_t index = static_cast<uint32_t>(m_locals.size());
+	m_locals.append(mat4f::identity());
+	m_worlds.append(mat4f::identity());
+	m_parents.append(InvalidIndex);
+	m_flags.append(0);
+	m_ids.append(id);
+	m_indices[EnumToValue(id)] = index;
+	// Roots belong to first level.
+	m_orderDirty = true;
+	return id;
+}
+void TransformHierarchy::destroy(TransformID id)
+{
+	const uint32_t index = getIndex(id);
+	// Removed on next sort, as moving transforms would break the depth order.
+	m_flags[index] = Removed;
+	m_ids[index] = TransformID::Invalid;
+	m_indices[EnumToValue(id)] = InvalidIndex;
+	m_freeIDs.append(id);
+	m_orderDirty = true;
+}
+void TransformHierarchy::setParent(TransformID id, TransformID parent)
+{
+	const uint32_t index = getIndex(id);
+	const uint32_t parentIndex = (parent == TransformID::Invalid) ? InvalidIndex : getIndex(parent);
+	AKA_ASSERT(index != parentIndex, "Transform cannot be its own parent");
+	if (m_parents[index] == parentIndex)
+		return;
+	m_parents[index] = parentIndex;
+	m_flags[index] |= Dirty;
+	m_orderDirty = true;
+}
+
+void TransformHierarchy::setLocal(TransformID id, const mat4f& transform)
+{
+	const uint32_t index = getIndex(id);
+	m_locals[index] = transform;
+	m_flags[index] |= Dirty;
+}
+void TransformHierarchy::setDirty(TransformID id)
+{
+	m_flags[getIndex(id)] |= Dirty;
+}
+const mat4f& TransformHierarchy::getLocal(TransformID id) const
+{
+	return m_locals[getIndex(id)];
+}
+const mat4f& TransformHierarchy::getWorld(TransformID id) const
+{
+	return m_worlds[getIndex(id)];
+}
+bool TransformHierarchy::isDirty(TransformID id) const
+{
+	return (m_flags[getIndex(id)] & Dirty) != 0;
+}
+bool TransformHierarchy::isUpdated(TransformID id) const
+{
+	return (m_flags[getIndex(id)] & Updated) != 0;
+}
+
+void TransformHierarchy::computeWorld(TransformID id)
+{
+	// Find the topmost dirty parent, as the world matrix of every parent below it is stale.
+	const uint32_t index = getIndex(id);
+	uint32_t first = index;
+	for (uint32_t parent = m_parents[index]; parent != InvalidIndex; parent = m_parents[parent])
+	{
+		if (m_flags[parent] & Dirty)
+			first = parent;
+	}
+	// Compute from there down to the transform, parents first.
+	SmallVector<uint32_t, 16> chain;
+	for (uint32_t current = index; current != first; current = m_parents[current])
+		chain.append(current);
+	chain.append(first);
+	for (size_t iChain = chain.size(); iChain > 0; iChain--)
+		compute(chain[iChain - 1]);
+}
+
+void TransformHierarchy::compute(uint32_t index)
+{
+	const uint32_t parent = m_parents[index];
+	if (parent == InvalidIndex)
+		m_worlds[index] = m_locals[index];
+	else
+		multiply(m_worlds[parent], m_locals[index], m_worlds[index]);
+	// Keep it updated so that its childs are refreshed by next propagation.
+	m_flags[index] = (m_flags[index] & ~Dirty) | Updated;
+}
+
+void TransformHierarchy::propagate(uint32_t index)
+{
+	const uint32_t parent = m_parents[index];
+	// Parent is always computed before, as it has a lower depth.
+	const bool parentUpdated = (parent != InvalidIndex) && (m_flags[parent] & Updated);
+	if ((m_flags[index] & Dirty) || parentUpdated)
+		compute(index);
+}
+
+void TransformHierarchy::update()
+{
+	if (m_orderDirty)
+		sort();
+	// Sorted by depth, so a single linear pass reach every parent before its childs.
+	const uint32_t count = static_cast<uint32_t>(m_locals.size());
+	for (uint32_t index = 0; index < count; index++)
+		propagate(index);
+}
+
+void TransformHierarchy::update(WorkerPool& pool)
+{
+	if (m_orderDirty)
+		sort();
+	// Transforms of a level only depend on previous levels, so each level is split between workers.
+	for (size_t iLevel = 0; iLevel < getDepthCount(); iLevel++)
+	{
+		const uint32_t begin = m_levels[iLevel];
+		const uint32_t end = m_levels[iLevel + 1];
+		const size_t grainSize = max<size_t>(getParallelGrainSize(pool, end - begin, 0), TransformGrainSize);
+		parallelFor(pool, begin, end, [this](size_t index) {
+			propagate(static_cast<uint32_t>(index));
+		}, grainSize);
+	}
+}
+
+void TransformHierarchy::clearUpdated()
+{
+	for (uint8_t& flags : m_flags)
+		flags &= ~Updated;
+}
+
+size_t TransformHierarchy::size() const
+{
+	return m_indices.size() - m_freeIDs.size();
+}
+size_t TransformHierarchy::getDepthCount() const
+{
+	return m_levels.size() - 1;
+}
+
+uint32_t TransformHierarchy::getIndex(TransformID id) const
+{
+	AKA_ASSERT(EnumToValue(id) < m_indices.size(), "Invalid transform ID");
+	const uint32_t index = m_indices[EnumToValue(id)];
+	AKA_ASSERT(index != InvalidIndex, "Transform was destroyed");
+	return index;
+}
+
+void TransformHierarchy::sort()
+{
+	static constexpr uint32_t UnknownDepth = ~0U;
+	const uint32_t count = static_cast<uint32_t>(m_locals.size());
+	// Compute depth of each transform. Parents might be after their childs since they were reparented.
+	Vector<uint32_t> depths(count, UnknownDepth);
+	Vector<uint32_t> stack;
+	uint32_t depthCount = 0;
+	for (uint32_t index = 0; index < count; index++)
+	{
+		if (m_flags[index] & Removed)
+			continue;
+		uint32_t current = index;
+		while (current != InvalidIndex && depths[current] == UnknownDepth)
+		{
+			AKA_ASSERT(stack.size() < count, "Cycle in transform hierarchy");
+			stack.append(current);
+			uint32_t parent = m_parents[current];
+			if (parent != InvalidIndex && (m_flags[parent] & Removed))
+			{
+				// Parent destroyed before its childs, they become roots.
+				m_parents[current] = InvalidIndex;
+				m_flags[current] |= Dirty;
+				parent = InvalidIndex;
+			}
+			current = parent;
+		}
+		uint32_t depth = (current == InvalidIndex) ? 0 : depths[current] + 1;
+		while (stack.size() > 0)
+		{
+			depths[stack.last()] = depth++;
+			stack.remove(&stack.last());
+		}
+		depthCount = max(depthCount, depth);
+	}
+	// Counting sort by depth, keeping previous order inside a level.
+	m_levels.clear();
+	m_levels.resize(depthCount + 1, 0);
+	for (uint32_t index = 0; index < count; index++)
+	{
+		if (!(m_flags[index] & Removed))
+			m_levels[depths[index] + 1]++;
+	}
+	for (uint32_t iLevel = 0; iLevel < depthCount; iLevel++)
+		m_levels[iLevel + 1] += m_levels[iLevel];
+	const uint32_t sortedCount = m_levels[depthCount];
+
+	Vector<uint32_t> cursors(m_levels.data(), depthCount);
+	Vector<uint32_t> remap(count, InvalidIndex);
+	Vector<mat4f> locals(sortedCount);
+	Vector<mat4f> worlds(sortedCount);
+	Vector<uint32_t> parents(sortedCount);
+	Vector<uint8_t> flags(sortedCount);
+	Vector<TransformID> ids(sortedCount);
+	for (uint32_t index = 0; index < count; index++)
+	{
+		if (m_flags[index] & Removed)
+			continue;
+		const uint32_t sorted = cursors[depths[index]]++;
+		remap[index] = sorted;
+		locals[sorted] = m_locals[index];
+		worlds[sorted] = m_worlds[index];
+		flags[sorted] = m_flags[index];
+		ids[sorted] = m_ids[index];
+		m_indices[EnumToValue(m_ids[index])] = sorted;
+	}
+	for (uint32_t index = 0; index < count; index++)
+	{
+		if (remap[index] != InvalidIndex)
+			parents[remap[index]] = (m_parents[index] == InvalidIndex) ? InvalidIndex : remap[m_parents[index]];
+	}
+	m_locals = std::move(locals);
+	m_worlds = std::move(worlds);
+	m_parents = std::move(parents);
+	m_flags = std::move(flags);
+	m_ids = std::move(ids);
+	m_orderDirty = false;
+}
+
+};
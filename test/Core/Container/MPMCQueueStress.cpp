@@ -0,0 +1,134 @@
+#include <Aka/Core/Container/MPMCQueue.h>
+
+#include <atomic>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+using namespace aka;
+
+// Stress MPMCQueue with concurrent producers & consumers mixing single, batch & empty operations.
+// Each value is the producer index & a sequence number, checked to be popped exactly once,
+// & in increasing order per producer for each consumer, as the queue is FIFO.
+
+static constexpr uint64_t ValuesPerProducer = 200000;
+static constexpr size_t ProducerCount = 4;
+static constexpr size_t ConsumerCount = 4;
+static constexpr size_t BatchSize = 7;
+using Queue = MPMCQueue<uint64_t, 256>;
+
+static uint64_t encode(uint64_t producer, uint64_t sequence) { return (producer << 32) | sequence; }
+static uint64_t getProducer(uint64_t value) { return value >> 32; }
+static uint64_t getSequence(uint64_t value) { return value & 0xffffffff; }
+
+static int checkZeroCount()
+{
+	int errors = 0;
+	Queue queue;
+	uint64_t value = 42;
+	if (queue.push(&value, 0) != 0) errors++;
+	if (!queue.push(value)) errors++;
+	// Must return right away, even with values queued.
+	if (queue.pop(&value, 0) != 0) errors++;
+	if (queue.size() != 1) errors++;
+	for (size_t i = 1; i < Queue::capacity(); i++)
+		queue.push(value);
+	if (queue.push(&value, 0) != 0) errors++;
+	if (queue.push(value)) errors++;
+	std::printf("zero count: %d errors\n", errors);
+	return errors;
+}
+
+static int checkConcurrent()
+{
+	Queue queue;
+	std::atomic<uint64_t> popped(0);
+	std::vector<std::atomic<uint8_t>> seen(ProducerCount * ValuesPerProducer);
+	for (std::atomic<uint8_t>& s : seen)
+		s.store(0, std::memory_order_relaxed);
+	std::atomic<int> errors(0);
+
+	std::vector<std::thread> threads;
+	for (size_t iProducer = 0; iProducer < ProducerCount; iProducer++)
+	{
+		threads.emplace_back([&queue, iProducer]() {
+			uint64_t sequence = 0;
+			uint64_t batch[BatchSize];
+			while (sequence < ValuesPerProducer)
+			{
+				if (sequence % 3 == 0)
+				{
+					const size_t count = (size_t)std::min<uint64_t>(BatchSize, ValuesPerProducer - sequence);
+					for (size_t i = 0; i < count; i++)
+						batch[i] = encode(iProducer, sequence + i);
+					sequence += queue.push(batch, count);
+					queue.push(batch, 0);
+				}
+				else if (queue.push(encode(iProducer, sequence)))
+				{
+					sequence++;
+				}
+			}
+		});
+	}
+	for (size_t iConsumer = 0; iConsumer < ConsumerCount; iConsumer++)
+	{
+		threads.emplace_back([&, iConsumer]() {
+			uint64_t last[ProducerCount];
+			for (uint64_t& l : last)
+				l = ~0ULL;
+			uint64_t batch[BatchSize];
+			auto consume = [&](uint64_t value) {
+				const uint64_t producer = getProducer(value);
+				const uint64_t sequence = getSequence(value);
+				if (producer >= ProducerCount || sequence >= ValuesPerProducer)
+				{
+					errors++;
+					return;
+				}
+				if (last[producer] != ~0ULL && sequence <= last[producer])
+					errors++; // Out of order
+				last[producer] = sequence;
+				if (seen[producer * ValuesPerProducer + sequence].fetch_add(1, std::memory_order_relaxed) != 0)
+					errors++; // Popped twice
+				popped.fetch_add(1, std::memory_order_relaxed);
+			};
+			while (popped.load(std::memory_order_relaxed) < ProducerCount * ValuesPerProducer)
+			{
+				if (iConsumer % 2 == 0)
+				{
+					const size_t count = queue.pop(batch, BatchSize);
+					for (size_t i = 0; i < count; i++)
+						consume(batch[i]);
+					queue.pop(batch, 0);
+				}
+				else
+				{
+					uint64_t value;
+					if (queue.pop(value))
+						consume(value);
+				}
+			}
+		});
+	}
+	for (std::thread& thread : threads)
+		thread.join();
+
+	for (const std::atomic<uint8_t>& s : seen)
+	{
+		if (s.load(std::memory_order_relaxed) != 1)
+			errors++; // Lost or duplicated
+	}
+	if (!queue.empty())
+		errors++;
+	std::printf("concurrent: %d errors\n", errors.load());
+	return errors.load();
+}
+
+int main()
+{
+	int errors = 0;
+	errors += checkZeroCount();
+	errors += checkConcurrent();
+	return errors == 0 ? 0 : 1;
+}
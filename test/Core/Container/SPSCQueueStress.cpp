@@ -0,0 +1,132 @@
+#include <Aka/Core/Container/SPSCQueue.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <thread>
+
+using namespace aka;
+
+// Stress SPSCQueue with a producer & a consumer mixing single & batch operations.
+// Values are pushed in sequence & checked to be popped in the same order, none lost or duplicated.
+// Batch size does not divide the capacity, so that batches regularly wrap around the ring.
+
+static constexpr uint64_t ValueCount = 1000000;
+static constexpr size_t BatchSize = 13;
+using Queue = SPSCQueue<uint64_t, 64>;
+
+static int checkWrapAround()
+{
+	int errors = 0;
+	Queue queue;
+	uint64_t batch[Queue::capacity()];
+	uint64_t pushed = 0;
+	uint64_t popped = 0;
+	// Move head & tail to every offset of the ring, then push & pop a batch crossing the end of it.
+	for (size_t offset = 0; offset < 2 * Queue::capacity(); offset++)
+	{
+		for (size_t i = 0; i < BatchSize; i++)
+			batch[i] = pushed + i;
+		pushed += queue.push(batch, BatchSize);
+		const size_t count = queue.pop(batch, BatchSize);
+		for (size_t i = 0; i < count; i++)
+		{
+			if (batch[i] != popped++)
+				errors++;
+		}
+		// Shift by one for next offset.
+		if (!queue.push(pushed++)) errors++;
+		uint64_t value;
+		if (!queue.pop(value) || value != popped++) errors++;
+	}
+	// Fill the whole ring with a single batch, further pushes fail until values are popped.
+	for (size_t i = 0; i < Queue::capacity(); i++)
+		batch[i] = pushed + i;
+	if (queue.push(batch, Queue::capacity()) != Queue::capacity()) errors++;
+	pushed += Queue::capacity();
+	if (queue.push(pushed)) errors++;
+	if (queue.push(batch, 1) != 0) errors++;
+	if (queue.size() != Queue::capacity()) errors++;
+	if (queue.pop(batch, Queue::capacity() + 1) != Queue::capacity()) errors++;
+	for (size_t i = 0; i < Queue::capacity(); i++)
+	{
+		if (batch[i] != popped++)
+			errors++;
+	}
+	uint64_t value;
+	if (queue.pop(value)) errors++;
+	if (queue.pop(batch, BatchSize) != 0) errors++;
+	if (!queue.empty()) errors++;
+	std::printf("wrap around: %d errors\n", errors);
+	return errors;
+}
+
+static int checkConcurrent()
+{
+	Queue queue;
+	int errors = 0;
+	std::thread producer([&queue]() {
+		uint64_t sequence = 0;
+		uint64_t batch[BatchSize];
+		while (sequence < ValueCount)
+		{
+			if (sequence % 2 == 0)
+			{
+				const size_t count = (size_t)std::min<uint64_t>(BatchSize, ValueCount - sequence);
+				for (size_t i = 0; i < count; i++)
+					batch[i] = sequence + i;
+				const size_t pushed = queue.push(batch, count);
+				sequence += pushed;
+				if (pushed == 0)
+					std::this_thread::yield(); // Full, let the consumer run.
+			}
+			else if (queue.push(sequence))
+			{
+				sequence++;
+			}
+			else
+			{
+				std::this_thread::yield();
+			}
+		}
+	});
+	std::thread consumer([&queue, &errors]() {
+		uint64_t expected = 0;
+		uint64_t batch[BatchSize];
+		while (expected < ValueCount)
+		{
+			if (expected % 3 == 0)
+			{
+				const size_t count = queue.pop(batch, BatchSize);
+				for (size_t i = 0; i < count; i++)
+				{
+					if (batch[i] != expected++)
+						errors++;
+				}
+				if (count == 0)
+					std::this_thread::yield(); // Empty, let the producer run.
+			}
+			else
+			{
+				uint64_t value;
+				if (!queue.pop(value))
+					std::this_thread::yield();
+				else if (value != expected++)
+					errors++;
+			}
+		}
+	});
+	producer.join();
+	consumer.join();
+	if (!queue.empty())
+		errors++;
+	std::printf("concurrent: %d errors\n", errors);
+	return errors;
+}
+
+int main()
+{
+	int errors = 0;
+	errors += checkWrapAround();
+	errors += checkConcurrent();
+	return errors == 0 ? 0 : 1;
+}
@@ -0,0 +1,115 @@
+#include <Aka/Core/Hash.hpp>
+
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+using namespace aka;
+
+// Measure throughput of FNV, wyhash & streaming wyhash over short keys & multi megabyte blobs.
+// Streaming digests are checked against one shot wyhash, whatever how the data is split.
+
+static constexpr size_t ShortKeyCount = 1 << 20;
+static constexpr size_t ShortKeySizes[] = { 4, 8, 16, 32, 64 };
+static constexpr size_t BlobSizes[] = { 1 << 20, 16 << 20 };
+static constexpr size_t BlobRoundCount = 4;
+
+// Deterministic random bytes, so that runs are comparable.
+static std::vector<uint8_t> generate(size_t size, uint64_t seed)
+{
+	std::vector<uint8_t> data(size);
+	for (uint8_t& byte : data)
+	{
+		seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+		byte = static_cast<uint8_t>(seed >> 56);
+	}
+	return data;
+}
+
+struct Backend
+{
+	const char* name;
+	uint64_t(*hash)(const void* data, size_t size);
+};
+static const Backend Backends[] = {
+	{ "fnv", [](const void* data, size_t size) -> uint64_t { return hash::fnv(data, size); } },
+	{ "wyhash", [](const void* data, size_t size) -> uint64_t { return hash::wyhash(data, size); } },
+	{ "wyhash state", [](const void* data, size_t size) -> uint64_t {
+		hash::WyhashState state;
+		state.update(data, size);
+		return state.digest();
+	} },
+};
+
+// Hashes are accumulated so that calls cannot be optimized away.
+static volatile uint64_t s_sink = 0;
+
+static void measureShortKeys()
+{
+	using Clock = std::chrono::steady_clock;
+	for (size_t keySize : ShortKeySizes)
+	{
+		// Keys are packed next to each other, like strings of a table.
+		const std::vector<uint8_t> keys = generate(ShortKeyCount * keySize, keySize);
+		for (const Backend& backend : Backends)
+		{
+			uint64_t sink = 0;
+			const Clock::time_point start = Clock::now();
+			for (size_t iKey = 0; iKey < ShortKeyCount; iKey++)
+				sink ^= backend.hash(keys.data() + iKey * keySize, keySize);
+			const Clock::time_point end = Clock::now();
+			s_sink = s_sink ^ sink;
+			const double time = std::chrono::duration<double, std::nano>(end - start).count();
+			std::printf("%3zu bytes keys %-14s %7.2f ns/key\n", keySize, backend.name, time / ShortKeyCount);
+		}
+	}
+}
+
+static void measureBlobs()
+{
+	using Clock = std::chrono::steady_clock;
+	for (size_t blobSize : BlobSizes)
+	{
+		const std::vector<uint8_t> blob = generate(blobSize, blobSize);
+		for (const Backend& backend : Backends)
+		{
+			uint64_t sink = 0;
+			const Clock::time_point start = Clock::now();
+			for (size_t iRound = 0; iRound < BlobRoundCount; iRound++)
+				sink ^= backend.hash(blob.data(), blob.size());
+			const Clock::time_point end = Clock::now();
+			s_sink = s_sink ^ sink;
+			const double seconds = std::chrono::duration<double>(end - start).count();
+			std::printf("%3zu MB blob %-18s %7.2f GB/s\n", blobSize >> 20, backend.name, (blobSize * BlobRoundCount) / seconds / 1e9);
+		}
+	}
+}
+
+static int checkStreaming()
+{
+	int errors = 0;
+	const std::vector<uint8_t> data = generate(4096 + 7, 1);
+	for (size_t size : { size_t(0), size_t(3), size_t(16), size_t(47), size_t(48), size_t(49), size_t(97), data.size() })
+	{
+		const uint64_t expected = hash::wyhash(data.data(), size, 5);
+		// Split in every chunk size up to a few blocks.
+		for (size_t chunkSize = 1; chunkSize <= 100; chunkSize++)
+		{
+			hash::WyhashState state(5);
+			for (size_t offset = 0; offset < size; offset += chunkSize)
+				state.update(data.data() + offset, size - offset < chunkSize ? size - offset : chunkSize);
+			if (state.digest() != expected)
+				errors++;
+		}
+	}
+	std::printf("streaming: %d errors\n", errors);
+	return errors;
+}
+
+int main()
+{
+	int errors = checkStreaming();
+	measureShortKeys();
+	measureBlobs();
+	return errors == 0 ? 0 : 1;
+}
@@ -0,0 +1,94 @@
+#include <Aka/Core/Hash.hpp>
+
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+using namespace aka;
+
+// Check that asset paths do not collide with FNV, used for AssetID, nor with wyhash, the default backend.
+// Corpus is every file below the given directories, as paths relative to them like AssetPath,
+// extended with generated paths following the layout of cooked assets so that it is big enough to be meaningful.
+
+static constexpr size_t GeneratedSceneCount = 256;
+static constexpr size_t GeneratedAssetCount = 1024;
+
+static void enumerate(const std::filesystem::path& root, std::vector<std::string>& paths)
+{
+	std::error_code error;
+	for (std::filesystem::recursive_directory_iterator it(root, error), end; !error && it != end; it.increment(error))
+	{
+		if (it->is_regular_file(error))
+			paths.push_back(std::filesystem::relative(it->path(), root, error).generic_string());
+	}
+}
+
+static void generate(std::vector<std::string>& paths)
+{
+	static const char* const Folders[] = { "meshes", "materials", "textures", "skeletons", "animations", "audio", "fonts" };
+	static const char* const Extensions[] = { ".smesh", ".mat", ".img", ".skel", ".anim", ".audio", ".font" };
+	for (size_t iScene = 0; iScene < GeneratedSceneCount; iScene++)
+	{
+		for (size_t iFolder = 0; iFolder < sizeof(Folders) / sizeof(*Folders); iFolder++)
+		{
+			for (size_t iAsset = 0; iAsset < GeneratedAssetCount; iAsset++)
+			{
+				paths.push_back(
+					std::string(".cooked/scene_") + std::to_string(iScene) + "/" + Folders[iFolder] +
+					"/asset_" + std::to_string(iAsset) + Extensions[iFolder]
+				);
+			}
+		}
+	}
+}
+
+template <typename Hash>
+static int countCollisions(const char* name, const std::vector<std::string>& paths, Hash&& hash)
+{
+	std::vector<std::pair<uint64_t, const std::string*>> hashes;
+	hashes.reserve(paths.size());
+	for (const std::string& path : paths)
+		hashes.emplace_back(hash(path), &path);
+	std::sort(hashes.begin(), hashes.end());
+	int collisions = 0;
+	size_t collisions32 = 0;
+	for (size_t i = 1; i < hashes.size(); i++)
+	{
+		if (hashes[i].first == hashes[i - 1].first)
+		{
+			std::printf("%s collision: %s & %s\n", name, hashes[i].second->c_str(), hashes[i - 1].second->c_str());
+			collisions++;
+		}
+	}
+	// Low 32 bits only, expected around n^2 / 2^33 for a good hash.
+	for (std::pair<uint64_t, const std::string*>& entry : hashes)
+		entry.first &= 0xffffffff;
+	std::sort(hashes.begin(), hashes.end());
+	for (size_t i = 1; i < hashes.size(); i++)
+	{
+		if (hashes[i].first == hashes[i - 1].first)
+			collisions32++;
+	}
+	const double expected32 = static_cast<double>(paths.size()) * static_cast<double>(paths.size()) / 8589934592.0;
+	std::printf("%-8s %d collisions, %zu on low 32 bits (%.1f expected)\n", name, collisions, collisions32, expected32);
+	return collisions;
+}
+
+int main(int argc, char* argv[])
+{
+	std::vector<std::string> paths;
+	for (int iArg = 1; iArg < argc; iArg++)
+		enumerate(argv[iArg], paths);
+	const size_t fileCount = paths.size();
+	generate(paths);
+	std::sort(paths.begin(), paths.end());
+	paths.erase(std::unique(paths.begin(), paths.end()), paths.end());
+	std::printf("%zu paths, %zu from files\n", paths.size(), fileCount);
+
+	int errors = 0;
+	errors += countCollisions("fnv", paths, [](const std::string& path) -> uint64_t { return hash::fnv(path.data(), path.size()); });
+	errors += countCollisions("wyhash", paths, [](const std::string& path) -> uint64_t { return hash::wyhash(path.data(), path.size()); });
+	return errors == 0 ? 0 : 1;
+}
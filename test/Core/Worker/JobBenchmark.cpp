@@ -0,0 +1,94 @@
+#include <Aka/Core/Worker/WorkerPool.h>
+#include <Aka/Memory/AllocatorTracker.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <functional>
+
+using namespace aka;
+
+// Compare submit & execute throughput of jobs storing their callable inline in a pooled record,
+// against jobs storing it in a std::function as LambdaJob did before, which allocate a callable per job.
+// Allocations are counted with the tracker, so the inline path should report none once records are warmed up.
+
+static constexpr size_t JobCount = 100000;
+static constexpr size_t RoundCount = 5;
+
+// Job as LambdaJob was before records, with its callable in a std::function.
+class FunctionJob : public Job
+{
+public:
+	FunctionJob(std::function<void()>&& function) : m_function(std::move(function)) {}
+protected:
+	void execute() override { m_function(); }
+private:
+	std::function<void()> m_function;
+};
+
+// Payload bigger than std::function small buffer, but small enough for LambdaJob inline storage.
+struct SmallPayload
+{
+	std::atomic<size_t>* executed;
+	uint64_t values[3];
+};
+// Payload bigger than LambdaJob inline storage, which then allocates like the previous path.
+struct BigPayload
+{
+	std::atomic<size_t>* executed;
+	uint64_t values[12];
+};
+
+template <typename Submit>
+static int measure(const char* name, WorkerPool& pool, Submit&& submit)
+{
+	using Clock = std::chrono::steady_clock;
+	int errors = 0;
+	double submitTime = 0.0;
+	double totalTime = 0.0;
+	size_t allocations = 0;
+	// First round warm up job records.
+	for (size_t iRound = 0; iRound <= RoundCount; iRound++)
+	{
+		std::atomic<size_t> executed(0);
+		JobCounter counter;
+		const size_t allocationCount = getAllocatorTracker().getStats().allocationCount;
+		const Clock::time_point start = Clock::now();
+		for (size_t iJob = 0; iJob < JobCount; iJob++)
+			submit(pool, counter, executed, iJob);
+		const Clock::time_point submitted = Clock::now();
+		pool.wait(counter);
+		const Clock::time_point finished = Clock::now();
+		if (executed.load() != JobCount)
+			errors++;
+		if (iRound == 0)
+			continue;
+		allocations += getAllocatorTracker().getStats().allocationCount - allocationCount;
+		submitTime += std::chrono::duration<double, std::nano>(submitted - start).count();
+		totalTime += std::chrono::duration<double, std::nano>(finished - start).count();
+	}
+	const double jobCount = static_cast<double>(JobCount * RoundCount);
+	std::printf("%-24s submit %8.1f ns/job, submit & execute %8.1f ns/job, %6.2f allocations/job\n",
+		name, submitTime / jobCount, totalTime / jobCount, allocations / jobCount);
+	return errors;
+}
+
+int main()
+{
+	WorkerPool pool;
+	std::printf("%zu jobs per round on %zu workers\n", JobCount, pool.count());
+	int errors = 0;
+	errors += measure("LambdaJob inline", pool, [](WorkerPool& _pool, JobCounter& _counter, std::atomic<size_t>& _executed, size_t _index) {
+		SmallPayload payload{ &_executed, { _index, _index, _index } };
+		_pool.run(_pool.createJob<LambdaJob>([payload]() { payload.executed->fetch_add(1, std::memory_order_relaxed); }), &_counter);
+	});
+	errors += measure("LambdaJob heap fallback", pool, [](WorkerPool& _pool, JobCounter& _counter, std::atomic<size_t>& _executed, size_t _index) {
+		BigPayload payload{ &_executed, { _index } };
+		_pool.run(_pool.createJob<LambdaJob>([payload]() { payload.executed->fetch_add(1, std::memory_order_relaxed); }), &_counter);
+	});
+	errors += measure("std::function job", pool, [](WorkerPool& _pool, JobCounter& _counter, std::atomic<size_t>& _executed, size_t _index) {
+		SmallPayload payload{ &_executed, { _index, _index, _index } };
+		_pool.run(_pool.createJob<FunctionJob>([payload]() { payload.executed->fetch_add(1, std::memory_order_relaxed); }), &_counter);
+	});
+	return errors == 0 ? 0 : 1;
+}
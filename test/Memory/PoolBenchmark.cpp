@@ -0,0 +1,97 @@
+#include <Aka/Memory/Pool.h>
+
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+using namespace aka;
+
+// Measure Pool acquire & release with 1k, 100k & 1M live objects.
+// Objects are released at random so that free chunks are spread over every block, like node & component churn.
+// Both operations are O(1), so time per operation on a hot set of objects should stay flat as the pool grows.
+// Churn over all objects also grows with cache misses, as the pool no longer fits in cache.
+
+static constexpr size_t OperationCount = 1000000;
+static constexpr size_t HotCount = 1000;
+
+struct Object
+{
+	Object(uint64_t _value) : value(_value) {}
+	uint64_t value;
+	float data[6];
+};
+
+// Deterministic random numbers, so that runs are comparable.
+static uint64_t next(uint64_t& state)
+{
+	state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+	return state >> 33;
+}
+
+static int measure(size_t liveCount)
+{
+	using Clock = std::chrono::steady_clock;
+	int errors = 0;
+	Pool<Object> pool;
+	std::vector<Object*> live;
+	live.reserve(liveCount);
+
+	const Clock::time_point fillStart = Clock::now();
+	for (size_t i = 0; i < liveCount; i++)
+		live.push_back(pool.acquire(i));
+	const Clock::time_point fillEnd = Clock::now();
+
+	// Release a random object & acquire a new one, keeping live count constant.
+	uint64_t state = 42;
+	auto churn = [&](size_t count) {
+		for (size_t i = 0; i < OperationCount; i++)
+		{
+			Object*& object = live[next(state) % count];
+			pool.release(object);
+			object = pool.acquire(i);
+		}
+	};
+	const Clock::time_point hotStart = Clock::now();
+	churn(HotCount);
+	const Clock::time_point hotEnd = Clock::now();
+	const Clock::time_point churnStart = Clock::now();
+	churn(liveCount);
+	const Clock::time_point churnEnd = Clock::now();
+
+	// Iterators should still visit every live object once.
+	size_t visited = 0;
+	for (Object& object : pool)
+	{
+		AKA_UNUSED(object);
+		visited++;
+	}
+	if (visited != liveCount || pool.count() != liveCount)
+		errors++;
+
+	const Clock::time_point releaseStart = Clock::now();
+	for (Object* object : live)
+		pool.release(object);
+	const Clock::time_point releaseEnd = Clock::now();
+	if (pool.count() != 0)
+		errors++;
+
+	auto perOperation = [](Clock::time_point start, Clock::time_point end, size_t count) {
+		return std::chrono::duration<double, std::nano>(end - start).count() / static_cast<double>(count);
+	};
+	std::printf("%8zu live objects, %6zu blocks: acquire %6.1f ns, hot release & acquire %6.1f ns, release & acquire %6.1f ns, release %6.1f ns\n",
+		liveCount, pool.getBlockCount(),
+		perOperation(fillStart, fillEnd, liveCount),
+		perOperation(hotStart, hotEnd, OperationCount),
+		perOperation(churnStart, churnEnd, OperationCount),
+		perOperation(releaseStart, releaseEnd, liveCount));
+	return errors;
+}
+
+int main()
+{
+	int errors = 0;
+	errors += measure(1000);
+	errors += measure(100000);
+	errors += measure(1000000);
+	return errors == 0 ? 0 : 1;
+}